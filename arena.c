@@ -0,0 +1,149 @@
+#include "arena.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define ALIGN_UP(n) (((n) + ARENA_ALIGNMENT - 1) & ~((size_t) ARENA_ALIGNMENT - 1))
+#define BLOCK_HEADER ALIGN_UP(sizeof(ArenaBlock))
+
+static ArenaBlock* new_block(Arena* arena, size_t min_size) {
+    size_t size = (min_size > arena->block_size) ? min_size : arena->block_size;
+    ArenaBlock* block = malloc(BLOCK_HEADER + size);
+    block->next = NULL;
+    block->size = size;
+    block->used = 0;
+    arena->block_allocations++;
+    return block;
+}
+
+Arena* create_arena(size_t block_size) {
+    Arena* arena = malloc(sizeof(Arena));
+    arena->block_size = (block_size == 0) ? ARENA_BLOCK_SIZE : ALIGN_UP(block_size);
+    arena->children = NULL;
+    arena->num_children = 0;
+    arena->block_allocations = 0;
+    arena->blocks = new_block(arena, 0);
+    arena->current = arena->blocks;
+    arena_reset(arena);
+    return arena;
+}
+
+void arena_reset(Arena* arena) {
+    for (ArenaBlock* block = arena->blocks; block != NULL; block = block->next) {
+        block->used = 0;
+    }
+    arena->current = arena->blocks;
+    memset(arena->free_lists, 0, sizeof(arena->free_lists));
+    arena->allocations = 0;
+
+    for (int i = 0; i < arena->num_children; i++) {
+        arena_reset(arena->children[i]);
+    }
+}
+
+void destroy_arena(Arena* arena) {
+    if (arena == NULL) {
+        return;
+    }
+    for (int i = 0; i < arena->num_children; i++) {
+        destroy_arena(arena->children[i]);
+    }
+    free(arena->children);
+
+    ArenaBlock* block = arena->blocks;
+    while (block != NULL) {
+        ArenaBlock* next = block->next;
+        free(block);
+        block = next;
+    }
+    free(arena);
+}
+
+Arena* arena_child(Arena* arena, int index) {
+    if (arena == NULL) {
+        return NULL;
+    }
+    if (index >= arena->num_children) {
+        arena->children = realloc(arena->children, (index + 1) * sizeof(Arena*));
+        for (int i = arena->num_children; i <= index; i++) {
+            arena->children[i] = create_arena(arena->block_size);
+        }
+        arena->num_children = index + 1;
+    }
+    return arena->children[index];
+}
+
+static void add_stats(const Arena* arena, ArenaStats* stats) {
+    stats->allocations += arena->allocations;
+    stats->block_allocations += arena->block_allocations;
+    for (const ArenaBlock* block = arena->blocks; block != NULL; block = block->next) {
+        stats->reserved += BLOCK_HEADER + block->size;
+    }
+    for (int i = 0; i < arena->num_children; i++) {
+        add_stats(arena->children[i], stats);
+    }
+}
+
+void arena_stats(const Arena* arena, ArenaStats* stats) {
+    stats->allocations = 0;
+    stats->block_allocations = 0;
+    stats->reserved = 0;
+    add_stats(arena, stats);
+}
+
+void* arena_alloc(Arena* arena, size_t size) {
+    if (arena == NULL) {
+        return malloc(size);
+    }
+
+    size = ALIGN_UP(size > 0 ? size : 1);
+    arena->allocations++;
+
+    size_t size_class = size / ARENA_ALIGNMENT - 1;
+    if (size_class < ARENA_FREE_CLASSES && arena->free_lists[size_class] != NULL) {
+        void* ptr = arena->free_lists[size_class];
+        arena->free_lists[size_class] = *(void**) ptr;
+        return ptr;
+    }
+
+    // Move on to the next kept block, or add one, once the current is full
+    while (arena->current->used + size > arena->current->size) {
+        if (arena->current->next == NULL) {
+            arena->current->next = new_block(arena, size);
+        }
+        arena->current = arena->current->next;
+    }
+
+    void* ptr = (char*) arena->current + BLOCK_HEADER + arena->current->used;
+    arena->current->used += size;
+    return ptr;
+}
+
+void arena_free(Arena* arena, void* ptr, size_t size) {
+    if (arena == NULL) {
+        free(ptr);
+        return;
+    }
+    if (ptr == NULL) {
+        return;
+    }
+
+    // Larger allocations stay in place until the next reset
+    size_t size_class = ALIGN_UP(size > 0 ? size : 1) / ARENA_ALIGNMENT - 1;
+    if (size_class < ARENA_FREE_CLASSES) {
+        *(void**) ptr = arena->free_lists[size_class];
+        arena->free_lists[size_class] = ptr;
+    }
+}
+
+void* arena_realloc(Arena* arena, void* ptr, size_t old_size, size_t new_size) {
+    if (arena == NULL) {
+        return realloc(ptr, new_size);
+    }
+
+    void* new_ptr = arena_alloc(arena, new_size);
+    if (ptr != NULL) {
+        memcpy(new_ptr, ptr, (old_size < new_size) ? old_size : new_size);
+        arena_free(arena, ptr, old_size);
+    }
+    return new_ptr;
+}
@@ -0,0 +1,54 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#define ARENA_BLOCK_SIZE (64 * 1024) // Default size of the blocks carved up by an arena
+#define ARENA_ALIGNMENT 16
+#define ARENA_FREE_CLASSES 4 // Freed allocations up to 64 bytes are recycled
+
+typedef struct ArenaBlock {
+    struct ArenaBlock* next;
+    size_t size;
+    size_t used;
+} ArenaBlock;
+
+// Bump allocator for the memory of one simulation run. Blocks are kept on
+// reset, so a run reusing the arena does not go back to the OS. Small freed
+// allocations, like queue nodes, are recycled through free lists
+typedef struct Arena {
+    ArenaBlock* blocks; // All blocks, in allocation order
+    ArenaBlock* current;
+    size_t block_size;
+    void* free_lists[ARENA_FREE_CLASSES];
+
+    // Arenas for threads working on the same run, kept across resets
+    struct Arena** children;
+    int num_children;
+
+    long long allocations; // Allocations since the last reset
+    long long block_allocations; // Blocks requested from the OS since creation
+} Arena;
+
+// Counters of an arena and all of its children
+typedef struct {
+    long long allocations;       // Allocations since the last reset
+    long long block_allocations; // Blocks requested from the OS since creation
+    size_t reserved;             // Bytes held in blocks
+} ArenaStats;
+
+// block_size of 0 selects ARENA_BLOCK_SIZE
+Arena* create_arena(size_t block_size);
+// Release all allocations at once, keeping the blocks for reuse
+void arena_reset(Arena* arena);
+void destroy_arena(Arena* arena);
+// Arena for the index-th thread of the run, only to be used by that thread
+Arena* arena_child(Arena* arena, int index);
+void arena_stats(const Arena* arena, ArenaStats* stats);
+
+// These fall back to malloc(), free() and realloc() if arena is NULL
+void* arena_alloc(Arena* arena, size_t size);
+void arena_free(Arena* arena, void* ptr, size_t size);
+void* arena_realloc(Arena* arena, void* ptr, size_t old_size, size_t new_size);
+
+#endif
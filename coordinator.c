@@ -1,173 +1,194 @@
 #include "input_parser.h"
-#include "scheduler.h"
+#include "io_trace.h"
+#include "libsched.h"
+#include "report.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #define OS_RAND_SEED 1
 
-void step(Scheduler* scheduler, Process** processes, int num_processes) {
-    int time_slice_remaining = TIME_SLICE;
-
-    int enter_io_flag = 0; // If a process needs to enter I/O, set this to 1, then it will be enqueued to the I/O queue at the end of the step
-    // Add new arriving processes
-    int new_processes_added = 0; // Number of new processes added to the ready queue
-    for (int i = 0; i < num_processes; i++) {
-        if (processes[i]->arrival_time == scheduler->current_time) {
-            add_new_process(scheduler, processes[i]);
-            new_processes_added++;
-        }
+static int parse_algorithm(const char* arg, SchedulingAlgorithm* algorithm) {
+    switch (atoi(arg)) {
+    case 1:
+        *algorithm = PREEMPTIVE_SJF;
+        return 0;
+    case 2:
+        *algorithm = ROUND_ROBIN;
+        return 0;
+    case 3:
+        *algorithm = MULTI_LEVEL_FEEDBACK;
+        return 0;
+    default:
+        fprintf(stderr, "Invalid scheduling algorithm choice\n");
+        return -1;
     }
+}
 
-    // Handle I/O completions
-    int completed_io_count = handle_io_completion(scheduler);
+// Parse <concurrency>:<mean service time>[:geometric|exponential|fixed] and
+// append the device to devices, returns 0 on success
+static int parse_io_device(const char* arg, IODeviceConfig* devices, int* num_devices) {
+    if (*num_devices >= MAX_IO_DEVICES) {
+        fprintf(stderr, "At most %d I/O devices are supported\n", MAX_IO_DEVICES);
+        return -1;
+    }
 
-    // Preempt the current process situations
-    if (new_processes_added + completed_io_count > 0 && scheduler->current_process != NULL) {
-        // If at least one new process has added to the ready queue, preempt the
-        // current process in PREEMPTIVE_SJF
-        if (scheduler->algorithm == PREEMPTIVE_SJF) {
-            enqueue(scheduler->ready_queue, scheduler->current_process);
-            scheduler->current_process = NULL;
-        }
-        // If at least one process has completed I/O, preempt the current
-        // process in MLFQ if there is one process in a higher priority queue
-        if (scheduler->algorithm == MULTI_LEVEL_FEEDBACK) {
-            int higher_priority_queue_size = 0;
-            for (int i = scheduler->current_process->priority_level - 1; i >= 0; i--) {
-                higher_priority_queue_size += scheduler->priority_queues[i]->size;
-            }
-            if (higher_priority_queue_size > 0) {
-                enqueue(scheduler->priority_queues[scheduler->current_process->priority_level], scheduler->current_process);
-                scheduler->current_process = NULL;
-            }
-        }
+    IODeviceConfig device;
+    char distribution[16] = "geometric";
+    if (sscanf(arg, "%d:%lf:%15s", &device.concurrency, &device.mean_service_time, distribution) < 2 || device.concurrency < 1 || device.mean_service_time < 0) {
+        fprintf(stderr, "Invalid I/O device: %s\n", arg);
+        return -1;
+    }
+    if (strcmp(distribution, "geometric") == 0) {
+        device.distribution = SERVICE_GEOMETRIC;
+    } else if (strcmp(distribution, "exponential") == 0) {
+        device.distribution = SERVICE_EXPONENTIAL;
+    } else if (strcmp(distribution, "fixed") == 0) {
+        device.distribution = SERVICE_FIXED;
+    } else {
+        fprintf(stderr, "Invalid service time distribution: %s\n", distribution);
+        return -1;
     }
 
-    // Schedule next process
-    if (scheduler->current_process == NULL) {
-        schedule_process(scheduler);
-        time_slice_remaining = TIME_SLICE;
+    devices[(*num_devices)++] = device;
+    return 0;
+}
+
+// ./coordinator --open-loop <scheduling_algorithm> [options], where algorithm 0
+// runs all three algorithms
+static int open_loop_main(int argc, char* argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s --open-loop <scheduling_algorithm|0> [--rate <arrivals per tick>] [--mean-burst <ticks>] [--burst-dist fixed|geometric] [--warmup <ticks>] [--duration <ticks>] [--max-in-flight <n>] [--seed <n>] [--io-device <concurrency>:<mean service>[:<dist>]]... [--sweep]\n", argv[0]);
+        return 1;
     }
 
-    // Update ready time for processes in ready queue.
-    node_t* current_ready_node = NULL;
-    if (scheduler->algorithm != MULTI_LEVEL_FEEDBACK) {
-        // Get the front of the ready queue
-        current_ready_node = scheduler->ready_queue->front;
-        while (current_ready_node != NULL) {
-            Process* p = (Process*) current_ready_node->data;
-            p->ready_time++;
-            current_ready_node = current_ready_node->next;
-        }
-    } else {
-        // MLFQ: Update ready time for processes
-        for (int i = 0; i < NUM_PRIORITY_LEVELS; i++) {
-            current_ready_node = scheduler->priority_queues[i]->front;
-            while (current_ready_node != NULL) {
-                Process* p = (Process*) current_ready_node->data;
-                p->ready_time++;
-                current_ready_node = current_ready_node->next;
-            }
+    SchedulingAlgorithm algorithms[] = {PREEMPTIVE_SJF, ROUND_ROBIN, MULTI_LEVEL_FEEDBACK};
+    int num_algorithms = 3;
+    if (strcmp(argv[2], "0") != 0) {
+        if (parse_algorithm(argv[2], &algorithms[0]) != 0) {
+            return 1;
         }
+        num_algorithms = 1;
     }
 
-    // Run current process
-    if (scheduler->current_process != NULL) {
-        Process* current = scheduler->current_process;
-
-        // Update time statistics by 1 unit
-        scheduler->current_time++;
-
-        current->running_time++;
-        current->allotment_time_used++;
-        current->remaining_time--;
-
-        time_slice_remaining--;
-
-        if (current->remaining_time == 0) {
-            // Check if the process has completed
-            handle_process_completion(scheduler);
-        } else if (IO_request()) {
-            // Check if the process has an I/O request
-            enter_io_flag = 1;
-        } else if (time_slice_remaining == 0 && scheduler->algorithm != PREEMPTIVE_SJF) {
-            // Check if the time slice has expired
-            if (scheduler->algorithm == ROUND_ROBIN) {
-                // If the algorithm is ROUND_ROBIN, enqueue the process back to
-                // the ready queue
-                enqueue(scheduler->ready_queue, current);
-            } else if (scheduler->algorithm == MULTI_LEVEL_FEEDBACK) {
-                int next_priority = (current->priority_level + 1 < NUM_PRIORITY_LEVELS) ? current->priority_level + 1 : NUM_PRIORITY_LEVELS - 1;
-                current->priority_level = next_priority;
-                current->allotment_time_used = 0;
-                enqueue(scheduler->priority_queues[next_priority], current);
+    OpenLoopConfig config;
+    init_open_loop_config(&config, algorithms[0]);
+    config.seed = OS_RAND_SEED;
+    int sweep = 0;
+
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+            config.arrival_rate = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--mean-burst") == 0 && i + 1 < argc) {
+            config.mean_burst = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--burst-dist") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "fixed") == 0) {
+                config.burst_distribution = BURST_FIXED;
+            } else if (strcmp(argv[i], "geometric") == 0) {
+                config.burst_distribution = BURST_GEOMETRIC;
+            } else {
+                fprintf(stderr, "Invalid burst distribution: %s\n", argv[i]);
+                return 1;
             }
-            scheduler->current_process = NULL;
-        } else if (scheduler->algorithm == MULTI_LEVEL_FEEDBACK && current->allotment_time_used >= TIME_SLICE) {
-            // MLF-Rule 4: Check if the process has used its allotment time in
-            // MLFQ, even it is already in the lowest priority queue
-            int next_priority = (current->priority_level + 1 < NUM_PRIORITY_LEVELS) ? current->priority_level + 1 : NUM_PRIORITY_LEVELS - 1;
-            current->priority_level = next_priority;
-            current->allotment_time_used = 0;
-            enqueue(scheduler->priority_queues[next_priority], current);
-            scheduler->current_process = NULL;
-        }
-    } else {
-        // If no process is currently running, simulate the passage of time
-        scheduler->current_time++;
-    }
-
-    if (scheduler->algorithm == MULTI_LEVEL_FEEDBACK) {
-        // MLF-Rule 5: Check if the boost time has come, and boost all processes
-        // in the lower priority queues to the highest priority queue
-        // The actual boost time is stored in the scheduler struct
-        // Here we increment the boost timer by 1 unit and push back the current process to the priority queue if it is not NULL
-        scheduler->boost_timer++;
-        if (scheduler->boost_timer >= MLFQ_BOOST_TIME) {
-            if (scheduler->current_process != NULL) {
-                enqueue(scheduler->priority_queues[scheduler->current_process->priority_level], scheduler->current_process);
+        } else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+            config.warmup_time = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--duration") == 0 && i + 1 < argc) {
+            config.duration = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--max-in-flight") == 0 && i + 1 < argc) {
+            config.max_in_flight = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            config.seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--io-device") == 0 && i + 1 < argc) {
+            if (parse_io_device(argv[++i], config.io_devices, &config.num_io_devices) != 0) {
+                return 1;
             }
-            scheduler->current_process = NULL;
+        } else if (strcmp(argv[i], "--sweep") == 0) {
+            sweep = 1;
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            return 1;
         }
     }
 
-    // Update I/O time for processes in I/O queue
-    node_t* current_io_node = scheduler->io_queue->front;
-    while (current_io_node != NULL) {
-        Process* p = (Process*) current_io_node->data;
-        p->io_time++;
-        current_io_node = current_io_node->next;
+    if (config.arrival_rate < 0 || config.mean_burst <= 0 || config.warmup_time < 0 || config.duration <= 0 || config.max_in_flight <= 0) {
+        fprintf(stderr, "Invalid open-loop configuration\n");
+        return 1;
     }
 
-    // If current process enters I/O, enqueue it to the I/O queue
-    if (enter_io_flag && scheduler->current_process != NULL) {
-        enqueue(scheduler->io_queue, scheduler->current_process);
-        scheduler->current_process = NULL;
-    }
+    report_open_loop(&config, algorithms, num_algorithms, sweep);
+    return 0;
 }
 
 int main(int argc, char* argv[]) {
-    if (argc != 3) {
-        fprintf(stderr, "Usage: %s <input_file> <scheduling_algorithm>\n", argv[0]);
+    if (argc >= 2 && strcmp(argv[1], "--open-loop") == 0) {
+        return open_loop_main(argc, argv);
+    }
+
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s <input_file> <scheduling_algorithm> [--record-io <file>] [--replay-io <file>] [--timeline <file>] [--cpus <n>] [--threads <n>] [--io-device <concurrency>:<mean service>[:<dist>]]...\n", argv[0]);
         return 1;
     }
 
     const char* input_file = argv[1];
-    int algorithm_choice = atoi(argv[2]);
+    const char* record_io_file = NULL;
+    const char* replay_io_file = NULL;
+    const char* timeline_file = NULL;
+    int num_cpus = 1;
+    int num_threads = 0; // One thread per CPU unless given
+    IODeviceConfig io_devices[MAX_IO_DEVICES];
+    int num_io_devices = 0;
+
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--record-io") == 0 && i + 1 < argc) {
+            record_io_file = argv[++i];
+        } else if (strcmp(argv[i], "--replay-io") == 0 && i + 1 < argc) {
+            replay_io_file = argv[++i];
+        } else if (strcmp(argv[i], "--timeline") == 0 && i + 1 < argc) {
+            timeline_file = argv[++i];
+        } else if (strcmp(argv[i], "--cpus") == 0 && i + 1 < argc) {
+            num_cpus = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            num_threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--io-device") == 0 && i + 1 < argc) {
+            if (parse_io_device(argv[++i], io_devices, &num_io_devices) != 0) {
+                return 1;
+            }
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    if (num_threads == 0) {
+        num_threads = num_cpus;
+    }
+    if (num_cpus < 1 || num_threads < 1) {
+        fprintf(stderr, "Invalid number of CPUs or threads\n");
+        return 1;
+    }
+    if (num_threads > num_cpus) {
+        // Every thread steps at least one CPU, like in create_multicore()
+        num_threads = num_cpus;
+    }
+    if (timeline_file != NULL && num_threads > 1) {
+        // The timeline ring buffer takes events from a single thread only
+        fprintf(stderr, "--timeline requires --threads 1\n");
+        return 1;
+    }
+    if (record_io_file != NULL && num_threads > 1) {
+        // Records from several threads would land in the file in any order
+        fprintf(stderr, "--record-io requires --threads 1\n");
+        return 1;
+    }
+    if (num_io_devices > 0 && num_cpus > 1) {
+        // Devices are owned by one scheduler and are not shared between CPUs
+        fprintf(stderr, "--io-device requires --cpus 1\n");
+        return 1;
+    }
 
     SchedulingAlgorithm algorithm;
-    switch (algorithm_choice) {
-    case 1:
-        algorithm = PREEMPTIVE_SJF;
-        break;
-    case 2:
-        algorithm = ROUND_ROBIN;
-        break;
-    case 3:
-        algorithm = MULTI_LEVEL_FEEDBACK;
-        break;
-    default:
-        fprintf(stderr, "Invalid scheduling algorithm choice\n");
+    if (parse_algorithm(argv[2], &algorithm) != 0) {
         return 1;
     }
 
@@ -178,20 +199,74 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    Scheduler* scheduler = create_scheduler(algorithm, num_processes);
-    os_srand(OS_RAND_SEED); // Seed the random number generator
+    // I/O is replayed if a trace is given or the input file scripts any burst
+    IOMode io_mode = IO_RANDOM;
+    if (replay_io_file != NULL) {
+        if (io_trace_load(replay_io_file, processes, num_processes) != 0) {
+            return 1;
+        }
+        io_mode = IO_REPLAY;
+    } else {
+        for (int i = 0; i < num_processes; i++) {
+            if (processes[i]->io_burst_count > 0) {
+                io_mode = IO_REPLAY;
+                break;
+            }
+        }
+    }
+
+    FILE* io_record_file = NULL;
+    if (record_io_file != NULL) {
+        io_record_file = io_trace_open(record_io_file);
+        if (io_record_file == NULL) {
+            return 1;
+        }
+    }
 
-    // Main simulation loop
-    while (scheduler->completed_processes < num_processes) {
-        // Advance the simulation by one time step
-        step(scheduler, processes, num_processes);
+    Timeline* timeline = NULL;
+    if (timeline_file != NULL) {
+        timeline = timeline_open(timeline_file);
+        if (timeline == NULL) {
+            return 1;
+        }
+    }
+
+    SimProcessSpec* specs = malloc((num_processes > 0 ? num_processes : 1) * sizeof(SimProcessSpec));
+    for (int i = 0; i < num_processes; i++) {
+        specs[i].pid = processes[i]->pid;
+        specs[i].arrival_time = processes[i]->arrival_time;
+        specs[i].service_time = processes[i]->service_time;
+        specs[i].priority = processes[i]->priority;
+        specs[i].io_bursts = processes[i]->io_bursts;
+        specs[i].io_burst_count = processes[i]->io_burst_count;
+    }
+
+    SimConfig config;
+    init_sim_config(&config, algorithm);
+    config.seed = OS_RAND_SEED;
+    config.io_mode = io_mode;
+    config.num_cpus = num_cpus;
+    config.num_threads = num_threads;
+    config.io_record_file = io_record_file;
+    config.timeline = timeline;
+    config.io_devices = io_devices;
+    config.num_io_devices = num_io_devices;
+
+    Simulation* simulation = create_simulation(&config, specs, num_processes);
+    SimResults results;
+    if (simulation == NULL || run_simulation(simulation, &results) != 0) {
+        fprintf(stderr, "Failed to run the simulation\n");
+        return 1;
     }
 
     // Print final statistics
-    print_statistics(scheduler);
+    print_statistics(&results);
 
     // Clean up
-    destroy_scheduler(scheduler);
+    destroy_simulation(simulation);
+    io_trace_close(io_record_file);
+    timeline_close(timeline);
+    free(specs);
     for (int i = 0; i < num_processes; i++) {
         destroy_process(processes[i]);
     }
@@ -5,6 +5,26 @@
 
 #define MAX_LINE_LENGTH 100
 
+typedef struct {
+    int pid;
+    IOBurst burst;
+} ScriptedBurst;
+
+// Replay expects the bursts of a process in CPU time order, but the input file
+// may list them in any order. Insertion sort keeps bursts at the same CPU time
+// in file order, and a process only has a handful of bursts
+static void sort_io_bursts(Process* p) {
+    for (int i = 1; i < p->io_burst_count; i++) {
+        IOBurst burst = p->io_bursts[i];
+        int j = i - 1;
+        while (j >= 0 && p->io_bursts[j].cpu_time > burst.cpu_time) {
+            p->io_bursts[j + 1] = p->io_bursts[j];
+            j--;
+        }
+        p->io_bursts[j + 1] = burst;
+    }
+}
+
 Process** parse_input(const char* filename, int* num_processes) {
     FILE* file = fopen(filename, "r");
     if (!file) {
@@ -17,10 +37,25 @@ Process** parse_input(const char* filename, int* num_processes) {
     *num_processes = 0;
     processes = (Process**) malloc(capacity * sizeof(Process*));
 
+    // Scripted I/O bursts are attached once the processes are sorted by PID
+    ScriptedBurst* io_lines = NULL;
+    int io_capacity = 0;
+    int io_count = 0;
+
     char line[MAX_LINE_LENGTH];
     while (fgets(line, MAX_LINE_LENGTH, file)) {
         int pid, arrival_time, service_time, priority;
-        if (sscanf(line, "%d:%d:%d:%d", &pid, &arrival_time, &service_time, &priority) == 4) {
+        int cpu_time, duration;
+        if (sscanf(line, "IO:%d:%d:%d", &pid, &cpu_time, &duration) == 3) {
+            if (io_count >= io_capacity) {
+                io_capacity = (io_capacity == 0) ? 10 : io_capacity * 2;
+                io_lines = (ScriptedBurst*) realloc(io_lines, io_capacity * sizeof(ScriptedBurst));
+            }
+            io_lines[io_count].pid = pid;
+            io_lines[io_count].burst.cpu_time = cpu_time;
+            io_lines[io_count].burst.duration = duration;
+            io_count++;
+        } else if (sscanf(line, "%d:%d:%d:%d", &pid, &arrival_time, &service_time, &priority) == 4) {
             if (*num_processes >= capacity) {
                 capacity *= 2;
                 processes = (Process**) realloc(processes, capacity * sizeof(Process*));
@@ -39,5 +74,23 @@ Process** parse_input(const char* filename, int* num_processes) {
         quicksort(processes, 0, *num_processes - 1);
     }
 
+    for (int i = 0; i < io_count; i++) {
+        Process* p = find_process(processes, *num_processes, io_lines[i].pid);
+        if (p == NULL) {
+            fprintf(stderr, "I/O burst references unknown pid %d\n", io_lines[i].pid);
+            continue;
+        }
+        if (io_lines[i].burst.cpu_time < 0 || io_lines[i].burst.duration < 0) {
+            fprintf(stderr, "I/O burst of pid %d has a negative CPU time or duration\n", io_lines[i].pid);
+            continue;
+        }
+        add_io_burst(p, io_lines[i].burst.cpu_time, io_lines[i].burst.duration);
+    }
+    free(io_lines);
+
+    for (int i = 0; i < *num_processes; i++) {
+        sort_io_bursts(processes[i]);
+    }
+
     return processes;
 }
@@ -0,0 +1,171 @@
+#include "io_device.h"
+#include <math.h>
+
+static int service_before(const IOService* a, const IOService* b) {
+    if (a->completion_time != b->completion_time) {
+        return a->completion_time < b->completion_time;
+    }
+    return a->process->pid < b->process->pid;
+}
+
+static void heap_push(IODeviceSet* set, IOService service) {
+    int i = set->in_service_count++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!service_before(&service, &set->in_service[parent])) {
+            break;
+        }
+        set->in_service[i] = set->in_service[parent];
+        i = parent;
+    }
+    set->in_service[i] = service;
+}
+
+static IOService heap_pop(IODeviceSet* set) {
+    IOService top = set->in_service[0];
+    IOService last = set->in_service[--set->in_service_count];
+    int i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= set->in_service_count) {
+            break;
+        }
+        if (child + 1 < set->in_service_count && service_before(&set->in_service[child + 1], &set->in_service[child])) {
+            child++;
+        }
+        if (!service_before(&set->in_service[child], &last)) {
+            break;
+        }
+        set->in_service[i] = set->in_service[child];
+        i = child;
+    }
+    if (set->in_service_count > 0) {
+        set->in_service[i] = last;
+    }
+    return top;
+}
+
+static void start_service(IODeviceSet* set, int device_index, Process* process, int current_time) {
+    IODevice* device = &set->devices[device_index];
+    device->busy++;
+    device->started++;
+    device->queue_delay += current_time - process->io_request_time;
+
+    IOService service;
+    service.completion_time = current_time + process->io_service_time;
+    service.device = device_index;
+    service.process = process;
+    heap_push(set, service);
+}
+
+IODeviceSet* create_io_devices(Arena* arena, const IODeviceConfig* configs, int num_devices) {
+    IODeviceSet* set = arena_alloc(arena, sizeof(IODeviceSet));
+    set->devices = arena_alloc(arena, num_devices * sizeof(IODevice));
+    set->num_devices = num_devices;
+    set->in_service_count = 0;
+    set->pending = 0;
+
+    // Every server holds at most one request, which bounds the heap
+    int servers = 0;
+    for (int i = 0; i < num_devices; i++) {
+        IODevice* device = &set->devices[i];
+        device->config = configs[i];
+        device->waiting = create_queue_in_arena(arena);
+        device->busy = 0;
+        device->started = 0;
+        device->completed = 0;
+        device->busy_time = 0;
+        device->queue_delay = 0;
+        device->queue_length_sum = 0;
+        device->max_queue_length = 0;
+        device->sampled_ticks = 0;
+        servers += configs[i].concurrency;
+    }
+    set->in_service = arena_alloc(arena, servers * sizeof(IOService));
+
+    return set;
+}
+
+void destroy_io_devices(Arena* arena, IODeviceSet* set) {
+    if (set == NULL) {
+        return;
+    }
+    int servers = 0;
+    for (int i = 0; i < set->num_devices; i++) {
+        destroy_queue(set->devices[i].waiting);
+        servers += set->devices[i].config.concurrency;
+    }
+    arena_free(arena, set->in_service, servers * sizeof(IOService));
+    arena_free(arena, set->devices, set->num_devices * sizeof(IODevice));
+    arena_free(arena, set, sizeof(IODeviceSet));
+}
+
+int sample_service_time(const IODevice* device, RandomState* random) {
+    double mean = device->config.mean_service_time;
+    double u = (random_next(random) + 1.0) / 2147483649.0; // Uniform in (0, 1)
+
+    switch (device->config.distribution) {
+    case SERVICE_FIXED:
+        return (int) lround(mean);
+    case SERVICE_EXPONENTIAL:
+        return (int) lround(-mean * log(u));
+    case SERVICE_GEOMETRIC:
+    default:
+        // Geometric on 0, 1, ... like the per-tick completion draws
+        if (mean <= 0) {
+            return 0;
+        }
+        return (int) floor(log(u) / log(mean / (mean + 1.0)));
+    }
+}
+
+int io_device_index(const IODeviceSet* set, int pid) {
+    // Each process always uses the same device
+    int index = pid % set->num_devices;
+    return (index < 0) ? index + set->num_devices : index;
+}
+
+void submit_io_request(IODeviceSet* set, Process* process, int current_time) {
+    int device_index = io_device_index(set, process->pid);
+    IODevice* device = &set->devices[device_index];
+    set->pending++;
+
+    if (device->busy < device->config.concurrency) {
+        start_service(set, device_index, process, current_time);
+    } else {
+        enqueue(device->waiting, process);
+    }
+}
+
+int collect_io_completions(IODeviceSet* set, int current_time, Process** completed) {
+    int count = 0;
+
+    // A request started here may finish at once, so keep popping until the
+    // earliest completion lies in the future
+    while (set->in_service_count > 0 && set->in_service[0].completion_time <= current_time) {
+        IOService service = heap_pop(set);
+        IODevice* device = &set->devices[service.device];
+        device->busy--;
+        device->completed++;
+        set->pending--;
+        completed[count++] = service.process;
+
+        if (!is_empty(device->waiting)) {
+            start_service(set, service.device, dequeue(device->waiting), current_time);
+        }
+    }
+
+    // Servers and waiting requests are sampled once per tick
+    for (int i = 0; i < set->num_devices; i++) {
+        IODevice* device = &set->devices[i];
+        int length = queue_size(device->waiting);
+        device->busy_time += device->busy;
+        device->queue_length_sum += length;
+        if (length > device->max_queue_length) {
+            device->max_queue_length = length;
+        }
+        device->sampled_ticks++;
+    }
+
+    return count;
+}
@@ -0,0 +1,64 @@
+#ifndef IO_DEVICE_H
+#define IO_DEVICE_H
+
+#include "arena.h"
+#include "process.h"
+#include "queue.h"
+#include "utilities.h"
+
+#define MAX_IO_DEVICES 16
+
+typedef enum { SERVICE_GEOMETRIC, SERVICE_EXPONENTIAL, SERVICE_FIXED } ServiceDistribution;
+
+typedef struct {
+    int concurrency;          // Requests served at the same time
+    double mean_service_time; // Mean ticks a request holds a server
+    ServiceDistribution distribution;
+} IODeviceConfig;
+
+// A device serves requests in FIFO order with a bounded number of servers
+typedef struct {
+    IODeviceConfig config;
+    queue_t* waiting; // Processes waiting for a free server
+    int busy;         // Servers in use
+
+    // Statistics
+    long long started;
+    long long completed;
+    long long busy_time;          // Server ticks spent serving requests
+    long long queue_delay;        // Ticks requests spent waiting for a server
+    long long queue_length_sum;   // Waiting requests summed over all ticks
+    int max_queue_length;
+    int sampled_ticks;
+} IODevice;
+
+// A request holding a server until its completion time
+typedef struct {
+    int completion_time;
+    int device;
+    Process* process;
+} IOService;
+
+typedef struct {
+    IODevice* devices;
+    int num_devices;
+    IOService* in_service; // Min-heap by completion time, then PID
+    int in_service_count;
+    int pending;           // Requests waiting or in service
+} IODeviceSet;
+
+IODeviceSet* create_io_devices(Arena* arena, const IODeviceConfig* configs, int num_devices);
+void destroy_io_devices(Arena* arena, IODeviceSet* set);
+// Index of the device serving the requests of a process
+int io_device_index(const IODeviceSet* set, int pid);
+// Draw the service time of a request from the device's distribution
+int sample_service_time(const IODevice* device, RandomState* random);
+// Queue a request of the process, which must have its io_request_time and
+// io_service_time set. It starts right away if the device has a free server
+void submit_io_request(IODeviceSet* set, Process* process, int current_time);
+// Move the requests finishing by current_time to completed, start waiting
+// requests on the freed servers and sample the queue lengths. completed must
+// hold set->pending processes. Returns the number of completed requests
+int collect_io_completions(IODeviceSet* set, int current_time, Process** completed);
+
+#endif
@@ -0,0 +1,89 @@
+#include "io_trace.h"
+#include "utilities.h"
+#include <string.h>
+
+#define IO_TRACE_READ_BATCH 1024
+
+FILE* io_trace_open(const char* filename) {
+    FILE* file = fopen(filename, "wb");
+    if (file == NULL) {
+        perror("Failed to open I/O trace file");
+        return NULL;
+    }
+
+    uint32_t version = IO_TRACE_VERSION;
+    fwrite(IO_TRACE_MAGIC, 1, 4, file);
+    fwrite(&version, sizeof(version), 1, file);
+    return file;
+}
+
+void io_trace_record(FILE* file, const Process* p, int tick, int duration) {
+    IOTraceRecord record;
+    record.pid = p->pid;
+    record.tick = tick;
+    record.cpu_time = p->running_time;
+    record.duration = duration;
+    fwrite(&record, sizeof(record), 1, file);
+}
+
+void io_trace_close(FILE* file) {
+    if (file != NULL) {
+        fclose(file);
+    }
+}
+
+int io_trace_load(const char* filename, Process** processes, int num_processes) {
+    FILE* file = fopen(filename, "rb");
+    if (file == NULL) {
+        perror("Failed to open I/O trace file");
+        return -1;
+    }
+
+    char magic[4];
+    uint32_t version;
+    if (fread(magic, 1, 4, file) != 4 || memcmp(magic, IO_TRACE_MAGIC, 4) != 0 || fread(&version, sizeof(version), 1, file) != 1 || version != IO_TRACE_VERSION) {
+        fprintf(stderr, "Invalid I/O trace file: %s\n", filename);
+        fclose(file);
+        return -1;
+    }
+
+    // A partial record at the end means the trace was cut short
+    long header_end = ftell(file);
+    if (fseek(file, 0, SEEK_END) != 0 || (ftell(file) - header_end) % sizeof(IOTraceRecord) != 0 || fseek(file, header_end, SEEK_SET) != 0) {
+        fprintf(stderr, "Truncated I/O trace file: %s\n", filename);
+        fclose(file);
+        return -1;
+    }
+
+    for (int i = 0; i < num_processes; i++) {
+        processes[i]->io_burst_count = 0;
+        processes[i]->next_io_burst = 0;
+    }
+
+    // Bursts of one process complete one after another, so the completion
+    // order of the log is also the replay order of each process
+    IOTraceRecord records[IO_TRACE_READ_BATCH];
+    size_t count;
+    while ((count = fread(records, sizeof(IOTraceRecord), IO_TRACE_READ_BATCH, file)) > 0) {
+        for (size_t i = 0; i < count; i++) {
+            Process* p = find_process(processes, num_processes, records[i].pid);
+            if (p == NULL) {
+                fprintf(stderr, "I/O trace references unknown pid %d\n", (int) records[i].pid);
+                continue;
+            }
+            if (records[i].cpu_time < 0 || records[i].duration < 0) {
+                fprintf(stderr, "I/O trace burst of pid %d has a negative CPU time or duration\n", (int) records[i].pid);
+                continue;
+            }
+            add_io_burst(p, records[i].cpu_time, records[i].duration);
+        }
+    }
+
+    if (ferror(file)) {
+        fprintf(stderr, "Failed to read I/O trace file: %s\n", filename);
+        fclose(file);
+        return -1;
+    }
+    fclose(file);
+    return 0;
+}
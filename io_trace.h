@@ -0,0 +1,29 @@
+#ifndef IO_TRACE_H
+#define IO_TRACE_H
+
+#include "process.h"
+#include <stdint.h>
+#include <stdio.h>
+
+#define IO_TRACE_MAGIC "IOTR"
+#define IO_TRACE_VERSION 1
+
+// One record per completed I/O burst, written in completion order
+typedef struct {
+    int32_t pid;
+    int32_t tick;     // Tick at which the I/O request was issued
+    int32_t cpu_time; // CPU time the process had used when it issued the request
+    int32_t duration; // Ticks spent sleeping on I/O
+} IOTraceRecord;
+
+// Open a trace file for writing and emit the header, returns NULL on failure
+FILE* io_trace_open(const char* filename);
+void io_trace_record(FILE* file, const Process* p, int tick, int duration);
+void io_trace_close(FILE* file);
+
+// Read a trace file sequentially and attach its bursts to the matching
+// processes, replacing any bursts they already had. The process array must be
+// sorted by PID. Returns 0 on success, -1 on failure
+int io_trace_load(const char* filename, Process** processes, int num_processes);
+
+#endif
@@ -0,0 +1,206 @@
+#include "libsched.h"
+#include "multicore.h"
+#include "simulation.h"
+#include <stdlib.h>
+#include <string.h>
+
+struct Simulation {
+    SimConfig config;
+    Arena* arena; // Holds all memory of a run, reset when the next run starts
+    int owns_arena;
+    int num_processes;
+    SimProcessSpec* specs; // Sorted by PID
+    IOBurst* bursts;       // Bursts of all specs, referenced by the copied specs
+    IODeviceConfig devices[MAX_IO_DEVICES];
+};
+
+static int compare_pid(const void* a, const void* b) {
+    const SimProcessSpec* x = a;
+    const SimProcessSpec* y = b;
+    return (x->pid > y->pid) - (x->pid < y->pid);
+}
+
+void init_sim_config(SimConfig* config, SchedulingAlgorithm algorithm) {
+    config->algorithm = algorithm;
+    config->seed = 1;
+    config->io_mode = IO_RANDOM;
+    config->num_cpus = 1;
+    config->num_threads = 1;
+    config->io_record_file = NULL;
+    config->timeline = NULL;
+    config->io_devices = NULL;
+    config->num_io_devices = 0;
+    config->arena = NULL;
+}
+
+Simulation* create_simulation(const SimConfig* config, const SimProcessSpec* processes, int num_processes) {
+    if (config->num_cpus < 1 || config->num_threads < 1 || num_processes < 0) {
+        return NULL;
+    }
+    if ((config->io_record_file != NULL || config->timeline != NULL) && config->num_threads > 1 && config->num_cpus > 1) {
+        return NULL;
+    }
+    if (config->num_io_devices < 0 || config->num_io_devices > MAX_IO_DEVICES || (config->num_io_devices > 0 && config->num_cpus > 1)) {
+        return NULL;
+    }
+    for (int i = 0; i < config->num_io_devices; i++) {
+        if (config->io_devices[i].concurrency < 1 || config->io_devices[i].mean_service_time < 0) {
+            return NULL;
+        }
+    }
+
+    int num_bursts = 0;
+    for (int i = 0; i < num_processes; i++) {
+        num_bursts += processes[i].io_burst_count;
+    }
+
+    Simulation* simulation = malloc(sizeof(Simulation));
+    simulation->config = *config;
+    if (config->num_io_devices > 0) {
+        memcpy(simulation->devices, config->io_devices, config->num_io_devices * sizeof(IODeviceConfig));
+        simulation->config.io_devices = simulation->devices;
+    }
+    simulation->owns_arena = (config->arena == NULL);
+    simulation->arena = simulation->owns_arena ? create_arena(0) : config->arena;
+    simulation->num_processes = num_processes;
+    simulation->specs = malloc((num_processes > 0 ? num_processes : 1) * sizeof(SimProcessSpec));
+    simulation->bursts = malloc((num_bursts > 0 ? num_bursts : 1) * sizeof(IOBurst));
+
+    IOBurst* bursts = simulation->bursts;
+    for (int i = 0; i < num_processes; i++) {
+        simulation->specs[i] = processes[i];
+        simulation->specs[i].io_bursts = bursts;
+        for (int j = 0; j < processes[i].io_burst_count; j++) {
+            *bursts++ = processes[i].io_bursts[j];
+        }
+    }
+
+    // Processes arriving together are admitted in PID order
+    qsort(simulation->specs, num_processes, sizeof(SimProcessSpec), compare_pid);
+
+    return simulation;
+}
+
+// Build the processes of a run in the arena, sorted by PID
+static Process** create_run_processes(Simulation* simulation) {
+    Arena* arena = simulation->arena;
+    Process** processes = arena_alloc(arena, simulation->num_processes * sizeof(Process*));
+
+    for (int i = 0; i < simulation->num_processes; i++) {
+        const SimProcessSpec* spec = &simulation->specs[i];
+        Process* p = create_process_in_arena(arena, spec->pid, spec->arrival_time, spec->service_time, spec->priority);
+        if (spec->io_burst_count > 0) {
+            p->io_bursts = arena_alloc(arena, spec->io_burst_count * sizeof(IOBurst));
+            memcpy(p->io_bursts, spec->io_bursts, spec->io_burst_count * sizeof(IOBurst));
+            p->io_burst_count = spec->io_burst_count;
+            p->io_burst_capacity = spec->io_burst_count;
+        }
+        processes[i] = p;
+    }
+    return processes;
+}
+
+static void collect_device_results(Simulation* simulation, const IODeviceSet* set, int total_time, SimResults* results) {
+    results->num_devices = set->num_devices;
+    results->devices = arena_alloc(simulation->arena, set->num_devices * sizeof(SimDeviceResult));
+
+    for (int i = 0; i < set->num_devices; i++) {
+        const IODevice* device = &set->devices[i];
+        SimDeviceResult* r = &results->devices[i];
+        r->concurrency = device->config.concurrency;
+        r->completed = device->completed;
+        r->max_queue_length = device->max_queue_length;
+        r->utilization = total_time > 0 ? (double) device->busy_time / ((double) total_time * device->config.concurrency) : 0;
+        r->mean_queue_delay = device->started > 0 ? (double) device->queue_delay / device->started : 0;
+        r->mean_queue_length = device->sampled_ticks > 0 ? (double) device->queue_length_sum / device->sampled_ticks : 0;
+        r->throughput = total_time > 0 ? (double) device->completed / total_time : 0;
+    }
+}
+
+static void collect_results(Simulation* simulation, Scheduler* scheduler, int migrations, SimResults* results) {
+    SimProcessResult* process_results = arena_alloc(simulation->arena, scheduler->total_processes * sizeof(SimProcessResult));
+
+    results->total_time = scheduler->current_time;
+    results->num_processes = scheduler->total_processes;
+    results->shortest_job_time = scheduler->shortest_job_time;
+    results->longest_job_time = scheduler->longest_job_time;
+    results->total_turnaround_time = scheduler->total_turnaround_time;
+    results->total_waiting_time = scheduler->total_waiting_time;
+    results->total_response_time = scheduler->total_response_time;
+    results->total_io_time = scheduler->total_io_time;
+    results->migrations = migrations;
+    results->processes = process_results;
+    results->num_devices = 0;
+    results->devices = NULL;
+
+    for (int i = 0; i < scheduler->total_processes; i++) {
+        Process* p = scheduler->all_processes[i];
+        SimProcessResult* r = &process_results[i];
+        r->pid = p->pid;
+        r->arrival_time = p->arrival_time;
+        r->service_time = p->service_time;
+        r->start_time = p->start_time;
+        r->completion_time = p->completion_time;
+        r->turnaround_time = p->turnaround_time;
+        r->waiting_time = p->waiting_time;
+        r->response_time = p->response_time;
+        r->ready_time = p->ready_time;
+        r->io_time = p->io_time;
+    }
+}
+
+int run_simulation(Simulation* simulation, SimResults* results) {
+    const SimConfig* config = &simulation->config;
+
+    // Everything left from the previous run goes at once
+    arena_reset(simulation->arena);
+    ArenaStats before;
+    arena_stats(simulation->arena, &before);
+    Process** processes = create_run_processes(simulation);
+
+    if (config->num_cpus == 1) {
+        Scheduler* scheduler = create_scheduler_in_arena(simulation->arena, config->algorithm, simulation->num_processes);
+        load_arrivals(scheduler, processes, simulation->num_processes);
+        os_srand(scheduler, config->seed);
+        scheduler->io_mode = config->io_mode;
+        scheduler->io_record_file = config->io_record_file;
+        scheduler->timeline = config->timeline;
+        add_io_devices(scheduler, config->io_devices, config->num_io_devices);
+
+        run_closed_trace(scheduler, simulation->num_processes);
+        collect_results(simulation, scheduler, 0, results);
+        if (scheduler->io_devices != NULL) {
+            collect_device_results(simulation, scheduler->io_devices, scheduler->current_time, results);
+        }
+    } else {
+        Multicore* multicore = create_multicore(simulation->arena, config->algorithm, config->num_cpus, config->num_threads, processes, simulation->num_processes, config->seed);
+        for (int i = 0; i < config->num_cpus; i++) {
+            multicore->cpus[i]->io_mode = config->io_mode;
+            multicore->cpus[i]->io_record_file = config->io_record_file;
+            multicore->cpus[i]->timeline = config->timeline;
+        }
+
+        if (run_multicore(multicore) != 0) {
+            return -1;
+        }
+        collect_results(simulation, merge_multicore_stats(multicore), multicore->migrations, results);
+    }
+
+    ArenaStats after;
+    arena_stats(simulation->arena, &after);
+    results->allocations = after.allocations;
+    results->os_allocations = after.block_allocations - before.block_allocations;
+    return 0;
+}
+
+void destroy_simulation(Simulation* simulation) {
+    if (simulation == NULL) {
+        return;
+    }
+    if (simulation->owns_arena) {
+        destroy_arena(simulation->arena);
+    }
+    free(simulation->specs);
+    free(simulation->bursts);
+    free(simulation);
+}
@@ -0,0 +1,95 @@
+#ifndef LIBSCHED_H
+#define LIBSCHED_H
+
+#include "scheduler.h"
+#include "workload.h"
+
+// Reentrant entry point for embedding the simulator. A simulation only uses
+// the state it owns: it never reads or writes global state, and it only
+// touches the filesystem through the trace handles the caller passes in
+
+typedef struct {
+    int pid;
+    int arrival_time;
+    int service_time;
+    int priority;
+    const IOBurst* io_bursts; // Scripted I/O bursts, used when io_mode is IO_REPLAY
+    int io_burst_count;
+} SimProcessSpec;
+
+typedef struct {
+    SchedulingAlgorithm algorithm;
+    unsigned int seed; // Seed of the random I/O events
+    IOMode io_mode;
+    int num_cpus;
+    int num_threads;
+
+    // Optional traces, owned by the caller and left open. The CPUs of a run
+    // write to them from their threads, so they need num_threads to be 1
+    FILE* io_record_file;
+    Timeline* timeline;
+
+    // Optional I/O devices, copied by create_simulation. Process p sends its
+    // requests to device p % num_io_devices. Only one CPU is supported
+    const IODeviceConfig* io_devices;
+    int num_io_devices;
+
+    // Optional arena for the memory of every run, owned by the caller. It is
+    // reset when a run starts, so one arena can serve many simulations run one
+    // after another. If NULL, the simulation creates its own
+    Arena* arena;
+} SimConfig;
+
+typedef struct {
+    int pid;
+    int arrival_time;
+    int service_time;
+    int start_time;
+    int completion_time;
+    int turnaround_time;
+    int waiting_time;
+    int response_time;
+    int ready_time;
+    int io_time;
+} SimProcessResult;
+
+typedef struct {
+    int concurrency;
+    long long completed;      // Requests served
+    int max_queue_length;
+    double utilization;       // Fraction of server time spent serving requests
+    double mean_queue_delay;  // Mean ticks a request waited for a server
+    double mean_queue_length; // Waiting requests averaged over all ticks
+    double throughput;        // Requests served per tick
+} SimDeviceResult;
+
+typedef struct {
+    int total_time; // Total simulation run time
+    int num_processes;
+    int shortest_job_time;
+    int longest_job_time;
+    int total_turnaround_time;
+    int total_waiting_time;
+    int total_response_time;
+    int total_io_time;
+    int migrations;              // Processes moved between CPUs
+    long long allocations;       // Allocations carved from the arena by the run
+    long long os_allocations;    // Blocks the arena requested from the OS during the run
+    SimProcessResult* processes; // In admission order, allocated in the simulation's arena
+    int num_devices;
+    SimDeviceResult* devices; // Allocated in the simulation's arena, NULL without devices
+} SimResults;
+
+typedef struct Simulation Simulation;
+
+void init_sim_config(SimConfig* config, SchedulingAlgorithm algorithm);
+// Create a simulation from an in-memory process array, which is copied
+Simulation* create_simulation(const SimConfig* config, const SimProcessSpec* processes, int num_processes);
+// Run the simulation from the start. It can be run again, and the per-process
+// results stay valid until its arena is reset by the next run, or until the
+// simulation is destroyed. Returns 0 on success, or -1 if the CPU threads
+// could not be started
+int run_simulation(Simulation* simulation, SimResults* results);
+void destroy_simulation(Simulation* simulation);
+
+#endif
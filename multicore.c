@@ -0,0 +1,208 @@
+#include "multicore.h"
+#include "simulation.h"
+#include <stdlib.h>
+
+typedef struct {
+    Multicore* multicore;
+    int index;
+} Worker;
+
+// Take a waiting process off a CPU. MLFQ gives up its least urgent process
+static Process* steal_process(Scheduler* scheduler) {
+    if (scheduler->algorithm != MULTI_LEVEL_FEEDBACK) {
+        return dequeue(scheduler->ready_queue);
+    }
+    for (int i = NUM_PRIORITY_LEVELS - 1; i >= 0; i--) {
+        if (!is_empty(scheduler->priority_queues[i])) {
+            return dequeue(scheduler->priority_queues[i]);
+        }
+    }
+    return NULL;
+}
+
+// Give every idle CPU, in CPU order, one process from the CPU with the most
+// waiting processes. Runs on a single thread between two barriers
+static void rebalance(Multicore* multicore) {
+    for (int i = 0; i < multicore->num_cpus; i++) {
+        Scheduler* idle = multicore->cpus[i];
+        if (idle->current_process != NULL || scheduler_ready_length(idle) > 0) {
+            continue;
+        }
+
+        Scheduler* busiest = NULL;
+        int busiest_length = 1; // A single waiting process is not worth moving
+        for (int j = 0; j < multicore->num_cpus; j++) {
+            int length = scheduler_ready_length(multicore->cpus[j]);
+            if (length > busiest_length) {
+                busiest = multicore->cpus[j];
+                busiest_length = length;
+            }
+        }
+        if (busiest == NULL) {
+            return;
+        }
+
+        Process* process = steal_process(busiest);
+        if (idle->algorithm == MULTI_LEVEL_FEEDBACK) {
+            enqueue(idle->priority_queues[process->priority_level], process);
+        } else {
+            enqueue(idle->ready_queue, process);
+        }
+        multicore->migrations++;
+    }
+}
+
+static void* worker_main(void* arg) {
+    Worker* worker = arg;
+    Multicore* multicore = worker->multicore;
+
+    // Wait until every thread is created, so that no thread is left waiting
+    // at the barrier if one of them could not be
+    pthread_mutex_lock(&multicore->start_lock);
+    int aborted = multicore->aborted;
+    pthread_mutex_unlock(&multicore->start_lock);
+    if (aborted) {
+        return NULL;
+    }
+
+    for (;;) {
+        int window_end = multicore->window_end;
+        for (int i = worker->index; i < multicore->num_cpus; i += multicore->num_threads) {
+            Scheduler* scheduler = multicore->cpus[i];
+            while (scheduler->current_time < window_end) {
+                step(scheduler);
+            }
+        }
+
+        if (pthread_barrier_wait(&multicore->barrier) == PTHREAD_BARRIER_SERIAL_THREAD) {
+            int completed = 0;
+            for (int i = 0; i < multicore->num_cpus; i++) {
+                completed += multicore->cpus[i]->completed_processes;
+            }
+            if (completed >= multicore->total_processes) {
+                multicore->done = 1;
+            } else {
+                rebalance(multicore);
+                multicore->window_end += MIGRATION_INTERVAL;
+            }
+        }
+        pthread_barrier_wait(&multicore->barrier);
+
+        if (multicore->done) {
+            return NULL;
+        }
+    }
+}
+
+Multicore* create_multicore(Arena* arena, SchedulingAlgorithm algorithm, int num_cpus, int num_threads, Process** processes, int num_processes, unsigned int seed) {
+    Multicore* multicore = arena_alloc(arena, sizeof(Multicore));
+    multicore->arena = arena;
+    multicore->algorithm = algorithm;
+    multicore->num_cpus = num_cpus;
+    multicore->num_threads = (num_threads > num_cpus) ? num_cpus : num_threads;
+    multicore->total_processes = num_processes;
+    multicore->migrations = 0;
+    multicore->window_end = MIGRATION_INTERVAL;
+    multicore->done = 0;
+    multicore->cpus = arena_alloc(arena, num_cpus * sizeof(Scheduler*));
+
+    // Deal the PID-sorted processes out to the CPUs in turn
+    Process** partition = arena_alloc(arena, num_processes * sizeof(Process*));
+    for (int i = 0; i < num_cpus; i++) {
+        int count = 0;
+        for (int j = i; j < num_processes; j += num_cpus) {
+            partition[count++] = processes[j];
+        }
+        // Every CPU is only stepped by one thread at a time, so it gets an
+        // arena of its own
+        multicore->cpus[i] = create_scheduler_in_arena(arena_child(arena, i), algorithm, count);
+        os_srand(multicore->cpus[i], seed + i);
+        load_arrivals(multicore->cpus[i], partition, count);
+    }
+    arena_free(arena, partition, num_processes * sizeof(Process*));
+
+    return multicore;
+}
+
+void destroy_multicore(Multicore* multicore) {
+    for (int i = 0; i < multicore->num_cpus; i++) {
+        destroy_scheduler(multicore->cpus[i]);
+    }
+    arena_free(multicore->arena, multicore->cpus, multicore->num_cpus * sizeof(Scheduler*));
+    arena_free(multicore->arena, multicore, sizeof(Multicore));
+}
+
+int run_multicore(Multicore* multicore) {
+    pthread_t* threads = arena_alloc(multicore->arena, multicore->num_threads * sizeof(pthread_t));
+    Worker* workers = arena_alloc(multicore->arena, multicore->num_threads * sizeof(Worker));
+    pthread_barrier_init(&multicore->barrier, NULL, multicore->num_threads);
+    pthread_mutex_init(&multicore->start_lock, NULL);
+    multicore->aborted = 0;
+
+    // The calling thread works as the first worker
+    int started = 1;
+    pthread_mutex_lock(&multicore->start_lock);
+    for (int i = 1; i < multicore->num_threads; i++) {
+        workers[i].multicore = multicore;
+        workers[i].index = i;
+        if (pthread_create(&threads[i], NULL, worker_main, &workers[i]) != 0) {
+            multicore->aborted = 1;
+            break;
+        }
+        started++;
+    }
+    pthread_mutex_unlock(&multicore->start_lock);
+
+    if (!multicore->aborted) {
+        workers[0].multicore = multicore;
+        workers[0].index = 0;
+        worker_main(&workers[0]);
+    }
+
+    for (int i = 1; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    pthread_mutex_destroy(&multicore->start_lock);
+    pthread_barrier_destroy(&multicore->barrier);
+    arena_free(multicore->arena, workers, multicore->num_threads * sizeof(Worker));
+    arena_free(multicore->arena, threads, multicore->num_threads * sizeof(pthread_t));
+
+    return multicore->aborted ? -1 : 0;
+}
+
+Scheduler* merge_multicore_stats(Multicore* multicore) {
+    Scheduler* merged = create_scheduler_in_arena(multicore->arena, multicore->algorithm, multicore->total_processes);
+
+    for (int i = 0; i < multicore->num_cpus; i++) {
+        Scheduler* cpu = multicore->cpus[i];
+        for (int j = 0; j < cpu->total_processes; j++) {
+            Process* p = cpu->all_processes[j];
+            merged->all_processes[merged->total_processes++] = p;
+            // CPUs keep ticking until the end of the last window, so the run
+            // time is taken from the last completion instead
+            if (p->completion_time > merged->current_time) {
+                merged->current_time = p->completion_time;
+            }
+        }
+
+        merged->completed_processes += cpu->completed_processes;
+        merged->total_turnaround_time += cpu->total_turnaround_time;
+        merged->total_waiting_time += cpu->total_waiting_time;
+        merged->total_response_time += cpu->total_response_time;
+        merged->total_io_time += cpu->total_io_time;
+        if (cpu->longest_job_time > merged->longest_job_time) {
+            merged->longest_job_time = cpu->longest_job_time;
+        }
+        if (cpu->shortest_job_time < merged->shortest_job_time) {
+            merged->shortest_job_time = cpu->shortest_job_time;
+        }
+    }
+
+    // List the processes in the order a single CPU would have admitted them
+    quicksort(merged->all_processes, 0, merged->total_processes - 1);
+    Process** temp = arena_alloc(multicore->arena, multicore->total_processes * sizeof(Process*));
+    sort_by_arrival(merged->all_processes, temp, merged->total_processes);
+    arena_free(multicore->arena, temp, multicore->total_processes * sizeof(Process*));
+
+    return merged;
+}
@@ -0,0 +1,40 @@
+#ifndef MULTICORE_H
+#define MULTICORE_H
+
+#include "scheduler.h"
+#include <pthread.h>
+
+#define MIGRATION_INTERVAL 100 // Ticks simulated between two load balancing points
+
+// Processes are partitioned across CPUs by PID and every CPU runs its own
+// scheduler. The CPUs are simulated on worker threads in windows of
+// MIGRATION_INTERVAL ticks. Between windows all threads meet at a barrier where
+// idle CPUs steal waiting processes from busy ones. Steals depend only on the
+// CPU states at the window boundary, so results do not depend on the number of
+// threads
+typedef struct {
+    Arena* arena; // CPU i allocates from child arena i, or from the heap if NULL
+    SchedulingAlgorithm algorithm;
+    int num_cpus;
+    int num_threads;
+    Scheduler** cpus;
+    int total_processes;
+    int migrations;
+
+    pthread_mutex_t start_lock; // Held while the threads are created
+    int aborted;                // Set if a thread could not be created
+    pthread_barrier_t barrier;
+    int window_end; // Ticks before this are simulated in the current window
+    int done;
+} Multicore;
+
+// Create the CPUs and partition the processes across them. Each CPU gets its
+// own random stream, the first one seeded with seed
+Multicore* create_multicore(Arena* arena, SchedulingAlgorithm algorithm, int num_cpus, int num_threads, Process** processes, int num_processes, unsigned int seed);
+void destroy_multicore(Multicore* multicore);
+// Returns 0 on success, -1 if the CPU threads could not be started
+int run_multicore(Multicore* multicore);
+// Merge the statistics of all CPUs into a single scheduler for printing
+Scheduler* merge_multicore_stats(Multicore* multicore);
+
+#endif
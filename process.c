@@ -2,7 +2,19 @@
 #include <stdlib.h>
 
 Process* create_process(int pid, int arrival_time, int service_time, int priority) {
-    Process* p = (Process*) malloc(sizeof(Process));
+    return create_process_in_arena(NULL, pid, arrival_time, service_time, priority);
+}
+
+Process* create_process_in_arena(Arena* arena, int pid, int arrival_time, int service_time, int priority) {
+    Process* p = (Process*) arena_alloc(arena, sizeof(Process));
+    p->arena = arena;
+    p->io_bursts = NULL;
+    p->io_burst_capacity = 0;
+    init_process(p, pid, arrival_time, service_time, priority);
+    return p;
+}
+
+void init_process(Process* p, int pid, int arrival_time, int service_time, int priority) {
     p->pid = pid;
     p->arrival_time = arrival_time;
     p->service_time = service_time;
@@ -18,11 +30,26 @@ Process* create_process(int pid, int arrival_time, int service_time, int priorit
     p->io_time = 0;
     p->priority_level = 0;
     p->allotment_time_used = 0;
-    return p;
+    p->io_burst_count = 0;
+    p->next_io_burst = 0;
+    p->io_request_time = 0;
+    p->io_service_time = 0;
 }
 
 void destroy_process(Process* p) {
-    free(p);
+    arena_free(p->arena, p->io_bursts, p->io_burst_capacity * sizeof(IOBurst));
+    arena_free(p->arena, p, sizeof(Process));
+}
+
+void add_io_burst(Process* p, int cpu_time, int duration) {
+    if (p->io_burst_count >= p->io_burst_capacity) {
+        int capacity = (p->io_burst_capacity == 0) ? 4 : p->io_burst_capacity * 2;
+        p->io_bursts = (IOBurst*) arena_realloc(p->arena, p->io_bursts, p->io_burst_capacity * sizeof(IOBurst), capacity * sizeof(IOBurst));
+        p->io_burst_capacity = capacity;
+    }
+    p->io_bursts[p->io_burst_count].cpu_time = cpu_time;
+    p->io_bursts[p->io_burst_count].duration = duration;
+    p->io_burst_count++;
 }
 
 void update_process_stats(Process* p, int current_time) {
@@ -1,6 +1,13 @@
 #ifndef PROCESS_H
 #define PROCESS_H
 
+#include "arena.h"
+
+typedef struct {
+    int cpu_time; // CPU time the process has used when it issues the request
+    int duration; // Ticks the process sleeps on I/O
+} IOBurst;
+
 typedef struct {
     int pid;
     int arrival_time;
@@ -17,11 +24,27 @@ typedef struct {
     int io_time;
     int priority_level;      // Added priority level for MLFQ
     int allotment_time_used; // Added allotment usage for MLFQ
+
+    // Scripted I/O bursts used when I/O is replayed instead of drawn at random
+    IOBurst* io_bursts;
+    int io_burst_count;
+    int io_burst_capacity;
+    int next_io_burst;   // Index of the next burst to replay
+    int io_request_time; // Tick at which the current I/O burst started
+    int io_service_time; // Ticks the current request holds an I/O device
+
+    Arena* arena; // The process and its bursts are allocated here, or on the heap if NULL
 } Process;
 
 // Function prototypes
 Process* create_process(int pid, int arrival_time, int service_time, int priority);
+Process* create_process_in_arena(Arena* arena, int pid, int arrival_time, int service_time, int priority);
+// Reset a process to its freshly created state so that it can be reused. The
+// I/O burst buffer is kept but emptied
+void init_process(Process* p, int pid, int arrival_time, int service_time, int priority);
 void destroy_process(Process* p);
+// Append an I/O burst to the process' replay script
+void add_io_burst(Process* p, int cpu_time, int duration);
 // Update process stats whenever a process is first scheduled or completed
 void update_process_stats(Process* p, int current_time);
 
@@ -4,15 +4,20 @@
 #include <stdlib.h>
 
 queue_t* create_queue() {
-    queue_t* queue = malloc(sizeof(queue_t));
+    return create_queue_in_arena(NULL);
+}
+
+queue_t* create_queue_in_arena(Arena* arena) {
+    queue_t* queue = arena_alloc(arena, sizeof(queue_t));
     queue->front = NULL;
     queue->rear = NULL;
     queue->size = 0;
+    queue->arena = arena;
     return queue;
 }
 
 void enqueue(queue_t* queue, void* element) {
-    node_t* new_node = malloc(sizeof(node_t));
+    node_t* new_node = arena_alloc(queue->arena, sizeof(node_t));
     new_node->data = element;
     new_node->next = NULL;
 
@@ -26,6 +31,31 @@ void enqueue(queue_t* queue, void* element) {
     queue->size++;
 }
 
+void enqueue_batch(queue_t* queue, void** elements, int count) {
+    if (count <= 0)
+        return;
+
+    // Build the chain off to the side, then link it to the queue once
+    node_t* first = arena_alloc(queue->arena, sizeof(node_t));
+    node_t* last = first;
+    first->data = elements[0];
+    for (int i = 1; i < count; i++) {
+        node_t* new_node = arena_alloc(queue->arena, sizeof(node_t));
+        new_node->data = elements[i];
+        last->next = new_node;
+        last = new_node;
+    }
+    last->next = NULL;
+
+    if (queue->rear == NULL) {
+        queue->front = first;
+    } else {
+        queue->rear->next = first;
+    }
+    queue->rear = last;
+    queue->size += count;
+}
+
 void* dequeue(queue_t* queue) {
     if (queue->front == NULL)
         return NULL;
@@ -38,7 +68,7 @@ void* dequeue(queue_t* queue) {
     if (queue->front == NULL)
         queue->rear = NULL;
 
-    free(temp);
+    release_node(queue, temp);
     queue->size--;
     return data;
 }
@@ -61,7 +91,11 @@ void destroy_queue(queue_t* queue) {
     while (!is_empty(queue)) {
         dequeue(queue);
     }
-    free(queue);
+    arena_free(queue->arena, queue, sizeof(queue_t));
+}
+
+void release_node(queue_t* queue, node_t* node) {
+    arena_free(queue->arena, node, sizeof(node_t));
 }
 
 void print_queue(queue_t* queue, void (*print_function)(void*)) {
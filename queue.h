@@ -1,6 +1,7 @@
 #ifndef QUEUE_H
 #define QUEUE_H
 
+#include "arena.h"
 #include <stdbool.h>
 
 typedef struct node {
@@ -12,15 +13,21 @@ typedef struct {
     node_t* front;
     node_t* rear;
     int size;
+    Arena* arena; // Queue and nodes are allocated here, or on the heap if NULL
 } queue_t;
 
 queue_t* create_queue();
+queue_t* create_queue_in_arena(Arena* arena);
 void enqueue(queue_t* queue, void* element);
+// Append several elements in order, splicing them onto the rear in one step
+void enqueue_batch(queue_t* queue, void** elements, int count);
 void* dequeue(queue_t* queue);
 void* peek(queue_t* queue);
 bool is_empty(queue_t* queue);
 int queue_size(queue_t* queue);
 void destroy_queue(queue_t* queue);
+// Free a node that has already been unlinked from the queue
+void release_node(queue_t* queue, node_t* node);
 
 // Optional: Add this if you want to print the queue for debugging
 void print_queue(queue_t* queue, void (*print_function)(void*));
@@ -0,0 +1,121 @@
+#include "report.h"
+#include <stdio.h>
+#include <sys/stat.h>
+
+static const double sweep_loads[] = {0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9, 0.95, 1.0, 1.1};
+static const char* algorithm_names[] = {"SJF", "RR", "MLFQ"};
+
+int ensure_output_directory() {
+    struct stat st = {0};
+    if (stat("output", &st) == -1) {
+        if (mkdir("output", 0700) == -1) {
+            perror("Failed to create output directory");
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void print_statistics(const SimResults* results) {
+    // Create output directory if it doesn't exist
+    // FIXME: The Job# column width breaks if the PID is single digit
+    if (ensure_output_directory() != 0) {
+        return;
+    }
+
+    // Open the output file
+    FILE* file = fopen("output/statistics_output.txt", "w");
+    if (file == NULL) {
+        perror("Failed to open output file");
+        return;
+    }
+
+    // Write to file instead of printing to console
+    fprintf(file, "|        | Total time      | Total time     | Total time |\n");
+    fprintf(file, "|  Job#  | in ready to run | in sleeping on | in system  |\n");
+    fprintf(file, "|        | state           | I/O state      |            |\n");
+    fprintf(file, "|--------|-----------------|----------------|------------|\n");
+
+    for (int i = 0; i < results->num_processes; i++) {
+        const SimProcessResult* p = &results->processes[i];
+        fprintf(file, "| pid%-2d | %-15d | %-14d | %-10d |\n", p->pid, p->ready_time, p->io_time, p->turnaround_time);
+    }
+
+    fprintf(file, "|--------|-----------------|----------------|------------|\n");
+    fprintf(file, "Total simulation run time: %d\n", results->total_time);
+    fprintf(file, "Total number of jobs: %d\n", results->num_processes);
+    fprintf(file, "Shortest job completion time: %d\n", results->shortest_job_time);
+    fprintf(file, "Longest job completion time: %d\n", results->longest_job_time);
+    fprintf(file, "Average job completion time: %.2f\n", (float) results->total_turnaround_time / results->num_processes);
+    fprintf(file, "Average job response time: %.2f\n", (float) results->total_response_time / results->num_processes);
+    fprintf(file, "Average time in ready queue: %.2f\n", (float) results->total_waiting_time / results->num_processes);
+    fprintf(file, "Average time sleeping on I/O: %.2f\n", (float) results->total_io_time / results->num_processes);
+
+    if (results->num_devices > 0) {
+        fprintf(file, "\n");
+        fprintf(file, "| Device | Servers | Requests | Throughput | Utilization | Queue delay | Queue length | Max queue |\n");
+        fprintf(file, "|--------|---------|----------|------------|-------------|-------------|--------------|-----------|\n");
+        for (int i = 0; i < results->num_devices; i++) {
+            const SimDeviceResult* d = &results->devices[i];
+            fprintf(file, "| %-6d | %-7d | %-8lld | %-10.4f | %-11.2f | %-11.2f | %-12.2f | %-9d |\n", i, d->concurrency, d->completed, d->throughput, d->utilization, d->mean_queue_delay, d->mean_queue_length, d->max_queue_length);
+        }
+    }
+
+    // Close the file
+    fclose(file);
+
+    printf("Statistics have been written to output/statistics.txt\n");
+}
+
+// The I/O device columns are only written if the runs use devices
+static void write_header(FILE* file, int devices) {
+    fprintf(file, "| Algorithm | Offered load | Throughput | Ready queue | In system | Mean latency | p50    | p90    | p99    | Max    | Arrivals | Dropped |");
+    fprintf(file, devices ? " I/O util | I/O delay |\n" : "\n");
+    fprintf(file, "|-----------|--------------|------------|-------------|-----------|--------------|--------|--------|--------|--------|----------|---------|");
+    fprintf(file, devices ? "----------|-----------|\n" : "\n");
+}
+
+static void write_row(FILE* file, const OpenLoopConfig* config, const OpenLoopResults* results) {
+    fprintf(file, "| %-9s | %-12.2f | %-10.4f | %-11.2f | %-9.2f | %-12.2f | %-6d | %-6d | %-6d | %-6d | %-8lld | %-7lld |", algorithm_names[config->algorithm], results->offered_load, results->throughput, results->mean_ready_length, results->mean_in_system, results->mean_latency, results->p50_latency, results->p90_latency, results->p99_latency, results->max_latency, results->arrivals, results->dropped);
+    if (config->num_io_devices > 0) {
+        fprintf(file, " %-8.2f | %-9.2f |", results->io_utilization, results->mean_io_queue_delay);
+    }
+    fprintf(file, "\n");
+}
+
+void report_open_loop(const OpenLoopConfig* config, const SchedulingAlgorithm* algorithms, int num_algorithms, int sweep) {
+    if (ensure_output_directory() != 0) {
+        return;
+    }
+    FILE* file = fopen("output/open_loop_output.txt", "w");
+    if (file == NULL) {
+        perror("Failed to open output file");
+        return;
+    }
+
+    int num_points = sweep ? (int) (sizeof(sweep_loads) / sizeof(sweep_loads[0])) : 1;
+    // One arena serves every run, its blocks are kept between runs
+    Arena* arena = create_arena(0);
+    write_header(file, config->num_io_devices > 0);
+    for (int i = 0; i < num_algorithms; i++) {
+        for (int j = 0; j < num_points; j++) {
+            OpenLoopConfig point = *config;
+            point.algorithm = algorithms[i];
+            point.arena = arena;
+            if (sweep) {
+                // The mean burst is kept and the arrival rate scaled to the load
+                point.arrival_rate = sweep_loads[j] / config->mean_burst;
+            }
+
+            OpenLoopResults results;
+            run_open_loop(&point, &results);
+            write_row(file, &point, &results);
+        }
+    }
+    destroy_arena(arena);
+    fprintf(file, "Warm-up time: %d\n", config->warmup_time);
+    fprintf(file, "Measured time: %d\n", config->duration);
+    fclose(file);
+
+    printf("Statistics have been written to output/open_loop_output.txt\n");
+}
@@ -0,0 +1,13 @@
+#ifndef REPORT_H
+#define REPORT_H
+
+#include "libsched.h"
+
+// Create the output directory if it doesn't exist, returns 0 on success
+int ensure_output_directory();
+void print_statistics(const SimResults* results);
+// Run every given algorithm at the configured arrival rate, or over a range of
+// offered loads if sweep is set, and write one result row per run
+void report_open_loop(const OpenLoopConfig* config, const SchedulingAlgorithm* algorithms, int num_algorithms, int sweep);
+
+#endif
@@ -1,33 +1,114 @@
 #include "scheduler.h"
-#include "utilities.h"
+#include "io_trace.h"
 #include <errno.h>
 #include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <sys/stat.h>
 
-int os_rand() {
-    return rand();
+int os_rand(Scheduler* scheduler) {
+    return random_next(&scheduler->random);
 }
 
-void os_srand(unsigned int seed) {
-    srand(seed);
+void os_srand(Scheduler* scheduler, unsigned int seed) {
+    random_seed(&scheduler->random, seed);
 }
 
-int IO_request() {
-    return (os_rand() % CHANCE_OF_IO_REQUEST == 0);
+int IO_request(Scheduler* scheduler) {
+    return (os_rand(scheduler) % CHANCE_OF_IO_REQUEST == 0);
 }
 
-int IO_complete() {
-    return (os_rand() % CHANCE_OF_IO_COMPLETE == 0);
+int IO_complete(Scheduler* scheduler) {
+    return (os_rand(scheduler) % CHANCE_OF_IO_COMPLETE == 0);
+}
+
+// Check if the running process issues an I/O request in this tick
+int process_requests_io(Scheduler* scheduler, Process* process) {
+    if (scheduler->io_mode == IO_REPLAY) {
+        // A request dropped by an MLFQ boost is retried on the next tick
+        return process->next_io_burst < process->io_burst_count && process->running_time >= process->io_bursts[process->next_io_burst].cpu_time;
+    }
+    return IO_request(scheduler);
+}
+
+// Check if the I/O burst of a sleeping process completes in this tick
+static int process_completes_io(Scheduler* scheduler, Process* process) {
+    if (scheduler->io_mode == IO_REPLAY) {
+        return scheduler->current_time - process->io_request_time >= process->io_bursts[process->next_io_burst].duration;
+    }
+    return IO_complete(scheduler);
+}
+
+void start_io(Scheduler* scheduler, Process* process) {
+    trace_event(scheduler, TIMELINE_IO_START, process);
+    process->io_request_time = scheduler->current_time;
+
+    if (scheduler->io_devices == NULL) {
+        enqueue(scheduler->io_queue, process);
+        return;
+    }
+
+    // On a device, a replayed burst gives the service time of the request
+    IODeviceSet* set = scheduler->io_devices;
+    if (scheduler->io_mode == IO_REPLAY) {
+        process->io_service_time = process->io_bursts[process->next_io_burst].duration;
+    } else {
+        process->io_service_time = sample_service_time(&set->devices[io_device_index(set, process->pid)], &scheduler->random);
+    }
+    submit_io_request(set, process, scheduler->current_time);
+}
+
+// Bookkeeping for a process whose I/O burst completes in this tick. On a device
+// the service time is recorded without the queueing, which replay recreates
+static void finish_io(Scheduler* scheduler, Process* process) {
+    if (scheduler->io_record_file != NULL) {
+        int duration = (scheduler->io_devices != NULL) ? process->io_service_time : scheduler->current_time - process->io_request_time;
+        io_trace_record(scheduler->io_record_file, process, process->io_request_time, duration);
+    }
+    if (scheduler->io_mode == IO_REPLAY) {
+        process->next_io_burst++;
+    }
+    trace_event(scheduler, TIMELINE_IO_END, process);
+}
+
+// Grow the scratch batch buffer so that it holds at least count processes
+static Process** reserve_batch(Scheduler* scheduler, int count) {
+    if (count > scheduler->batch_capacity) {
+        int capacity = (count > 2 * scheduler->batch_capacity) ? count : 2 * scheduler->batch_capacity;
+        scheduler->batch = arena_realloc(scheduler->arena, scheduler->batch, scheduler->batch_capacity * sizeof(Process*), capacity * sizeof(Process*));
+        scheduler->batch_capacity = capacity;
+    }
+    return scheduler->batch;
+}
+
+// Append processes to the ready queue, or to the queue of their priority level
+// in MLFQ. Each run of processes bound for the same queue is spliced at once,
+// so every queue receives them in the given order
+static void enqueue_ready_batch(Scheduler* scheduler, Process** processes, int count) {
+    if (scheduler->algorithm != MULTI_LEVEL_FEEDBACK) {
+        enqueue_batch(scheduler->ready_queue, (void**) processes, count);
+        return;
+    }
+
+    int start = 0;
+    for (int i = 1; i <= count; i++) {
+        if (i == count || processes[i]->priority_level != processes[start]->priority_level) {
+            enqueue_batch(scheduler->priority_queues[processes[start]->priority_level], (void**) &processes[start], i - start);
+            start = i;
+        }
+    }
 }
 
 Scheduler* create_scheduler(SchedulingAlgorithm algorithm, int num_processes) {
-    Scheduler* scheduler = malloc(sizeof(Scheduler));
-    scheduler->all_processes = malloc(num_processes * sizeof(Process*));
+    return create_scheduler_in_arena(NULL, algorithm, num_processes);
+}
+
+Scheduler* create_scheduler_in_arena(Arena* arena, SchedulingAlgorithm algorithm, int num_processes) {
+    Scheduler* scheduler = arena_alloc(arena, sizeof(Scheduler));
+    scheduler->arena = arena;
+    scheduler->all_processes = (num_processes > 0) ? arena_alloc(arena, num_processes * sizeof(Process*)) : NULL;
     scheduler->algorithm = algorithm;
-    scheduler->ready_queue = create_queue();
-    scheduler->io_queue = create_queue();
+    scheduler->ready_queue = create_queue_in_arena(arena);
+    scheduler->io_queue = create_queue_in_arena(arena);
     scheduler->current_process = NULL;
     scheduler->current_time = 0;
     scheduler->total_processes = 0;
@@ -35,9 +116,22 @@ Scheduler* create_scheduler(SchedulingAlgorithm algorithm, int num_processes) {
 
     // Initialize priority queues for MLFQ
     scheduler->boost_timer = 0;
+    scheduler->io_mode = IO_RANDOM;
+    scheduler->io_record_file = NULL;
+    scheduler->io_devices = NULL;
+    os_srand(scheduler, 1);
+    scheduler->timeline = NULL;
+    scheduler->arrivals = NULL;
+    scheduler->num_arrivals = 0;
+    scheduler->arrivals_capacity = 0;
+    scheduler->next_arrival = 0;
+    scheduler->batch = NULL;
+    scheduler->batch_capacity = 0;
+    scheduler->on_complete = NULL;
+    scheduler->on_complete_context = NULL;
     if (algorithm == MULTI_LEVEL_FEEDBACK) {
         for (int i = 0; i < NUM_PRIORITY_LEVELS; i++) {
-            scheduler->priority_queues[i] = create_queue();
+            scheduler->priority_queues[i] = create_queue_in_arena(arena);
         }
     }
 
@@ -55,6 +149,7 @@ Scheduler* create_scheduler(SchedulingAlgorithm algorithm, int num_processes) {
 void destroy_scheduler(Scheduler* scheduler) {
     destroy_queue(scheduler->ready_queue);
     destroy_queue(scheduler->io_queue);
+    destroy_io_devices(scheduler->arena, scheduler->io_devices);
 
     if (scheduler->algorithm == MULTI_LEVEL_FEEDBACK) {
         for (int i = 0; i < NUM_PRIORITY_LEVELS; i++) {
@@ -62,8 +157,10 @@ void destroy_scheduler(Scheduler* scheduler) {
         }
     }
 
-    free(scheduler->all_processes);
-    free(scheduler);
+    arena_free(scheduler->arena, scheduler->arrivals, scheduler->arrivals_capacity * sizeof(Process*));
+    arena_free(scheduler->arena, scheduler->batch, scheduler->batch_capacity * sizeof(Process*));
+    arena_free(scheduler->arena, scheduler->all_processes, 0);
+    arena_free(scheduler->arena, scheduler, sizeof(Scheduler));
 }
 
 void schedule_process(Scheduler* scheduler) {
@@ -95,79 +192,133 @@ void schedule_process(Scheduler* scheduler) {
         }
 
         update_process_stats(scheduler->current_process, scheduler->current_time);
+        trace_event(scheduler, TIMELINE_DISPATCH, scheduler->current_process);
     }
 }
 
 void handle_process_completion(Scheduler* scheduler) {
     Process* completed_process = scheduler->current_process;
     update_process_stats(completed_process, scheduler->current_time);
-    update_scheduler_stats(scheduler, completed_process);
+    trace_event(scheduler, TIMELINE_COMPLETE, completed_process);
+    if (scheduler->on_complete != NULL) {
+        scheduler->on_complete(scheduler->on_complete_context, completed_process);
+    } else {
+        update_scheduler_stats(scheduler, completed_process);
+    }
     scheduler->completed_processes++;
     scheduler->current_process = NULL;
     // Update statistics here
 }
 
-int handle_io_completion(Scheduler* scheduler) {
-    if (is_empty(scheduler->io_queue)) {
-        return 0;
+// Processes sleeping on I/O devices are not in the I/O queue, so their sleep is
+// added to their I/O time when they complete
+static int handle_device_completion(Scheduler* scheduler) {
+    IODeviceSet* set = scheduler->io_devices;
+    Process** completed_array = reserve_batch(scheduler, set->pending);
+    int completed_count = collect_io_completions(set, scheduler->current_time, completed_array);
+
+    for (int i = 0; i < completed_count; i++) {
+        completed_array[i]->io_time += scheduler->current_time - completed_array[i]->io_request_time;
+        finish_io(scheduler, completed_array[i]);
     }
 
-    queue_t* temp_queue = create_queue();
-    queue_t* completed_io = create_queue();
+    quicksort(completed_array, 0, completed_count - 1);
+    enqueue_ready_batch(scheduler, completed_array, completed_count);
+    return completed_count;
+}
 
-    // Traverse the IO queue
-    while (!is_empty(scheduler->io_queue)) {
-        Process* io_process = dequeue(scheduler->io_queue);
-        if (IO_complete()) {
-            // If IO is complete, add to completed_io queue
-            enqueue(completed_io, io_process);
-        } else {
-            // If IO is not complete, add back to temp queue
-            enqueue(temp_queue, io_process);
-        }
+int handle_io_completion(Scheduler* scheduler) {
+    if (scheduler->io_devices != NULL) {
+        return handle_device_completion(scheduler);
     }
 
-    // Sort completed IO processes by PID
-    int completed_count = queue_size(completed_io);
-    Process** completed_array = malloc(completed_count * sizeof(Process*));
-    for (int i = 0; i < completed_count; i++) {
-        completed_array[i] = dequeue(completed_io);
+    queue_t* io_queue = scheduler->io_queue;
+    if (is_empty(io_queue)) {
+        return 0;
     }
 
-    // Sort the completed processes by PID
-    quicksort(completed_array, 0, completed_count - 1);
+    // Unlink completed processes from the I/O queue in a single pass. The
+    // completion checks run in queue order to keep the random draws in sequence
+    Process** completed_array = reserve_batch(scheduler, queue_size(io_queue));
+    int completed_count = 0;
+    node_t* prev = NULL;
+    node_t* current = io_queue->front;
+    while (current != NULL) {
+        node_t* next = current->next;
+        Process* io_process = (Process*) current->data;
 
-    // Enqueue sorted completed processes to ready queue
-    for (int i = 0; i < completed_count; i++) {
-        if (scheduler->algorithm == MULTI_LEVEL_FEEDBACK) {
-            enqueue(scheduler->priority_queues[completed_array[i]->priority_level], completed_array[i]);
+        if (process_completes_io(scheduler, io_process)) {
+            finish_io(scheduler, io_process);
+            completed_array[completed_count++] = io_process;
+
+            if (prev == NULL) {
+                io_queue->front = next;
+            } else {
+                prev->next = next;
+            }
+            if (current == io_queue->rear) {
+                io_queue->rear = prev;
+            }
+            release_node(io_queue, current);
+            io_queue->size--;
         } else {
-            enqueue(scheduler->ready_queue, completed_array[i]);
+            prev = current;
         }
+        current = next;
     }
 
-    free(completed_array);
-
-    // Move remaining processes back to IO queue
-    while (!is_empty(temp_queue)) {
-        enqueue(scheduler->io_queue, dequeue(temp_queue));
-    }
-
-    destroy_queue(temp_queue);
-    destroy_queue(completed_io);
+    // Sort the completed processes by PID and splice them into the ready queues
+    quicksort(completed_array, 0, completed_count - 1);
+    enqueue_ready_batch(scheduler, completed_array, completed_count);
 
     return completed_count;
 }
 
 void add_new_process(Scheduler* scheduler, Process* process) {
-    scheduler->all_processes[scheduler->total_processes] = process;
-    scheduler->total_processes++;
-    if (scheduler->algorithm == MULTI_LEVEL_FEEDBACK) {
-        // New processes always start in the highest priority queue
-        enqueue(scheduler->priority_queues[0], process);
-    } else {
-        enqueue(scheduler->ready_queue, process);
+    add_new_processes(scheduler, &process, 1);
+}
+
+void add_new_processes(Scheduler* scheduler, Process** processes, int count) {
+    for (int i = 0; i < count; i++) {
+        if (scheduler->all_processes != NULL) {
+            scheduler->all_processes[scheduler->total_processes] = processes[i];
+        }
+        scheduler->total_processes++;
+        trace_event(scheduler, TIMELINE_ARRIVE, processes[i]);
+    }
+    // New processes always start in the highest priority queue
+    enqueue_ready_batch(scheduler, processes, count);
+}
+
+void load_arrivals(Scheduler* scheduler, Process** processes, int num_processes) {
+    // The input is sorted by PID and the sort is stable, so processes arriving
+    // in the same tick are admitted in PID order
+    if (num_processes > scheduler->arrivals_capacity) {
+        scheduler->arrivals = arena_realloc(scheduler->arena, scheduler->arrivals, scheduler->arrivals_capacity * sizeof(Process*), num_processes * sizeof(Process*));
+        scheduler->arrivals_capacity = num_processes;
     }
+    for (int i = 0; i < num_processes; i++) {
+        scheduler->arrivals[i] = processes[i];
+    }
+    sort_by_arrival(scheduler->arrivals, reserve_batch(scheduler, num_processes), num_processes);
+    scheduler->num_arrivals = num_processes;
+    scheduler->next_arrival = 0;
+}
+
+int admit_arrivals(Scheduler* scheduler) {
+    int first = scheduler->next_arrival;
+    while (first < scheduler->num_arrivals && scheduler->arrivals[first]->arrival_time < scheduler->current_time) {
+        first++;
+    }
+
+    int last = first;
+    while (last < scheduler->num_arrivals && scheduler->arrivals[last]->arrival_time == scheduler->current_time) {
+        last++;
+    }
+
+    scheduler->next_arrival = last;
+    add_new_processes(scheduler, &scheduler->arrivals[first], last - first);
+    return last - first;
 }
 
 // Implement the scheduling algorithm specific functions here
@@ -210,7 +361,7 @@ Process* select_next_process_sjf(Scheduler* scheduler) {
         scheduler->ready_queue->rear = shortest_prev;
     }
 
-    free(shortest_node);
+    release_node(scheduler->ready_queue, shortest_node);
     scheduler->ready_queue->size--;
 
     return shortest_job;
@@ -234,12 +385,16 @@ Process* select_next_process_mlfq(Scheduler* scheduler) {
     if (scheduler->boost_timer >= MLFQ_BOOST_TIME) {
         int temp_process_count = 0;
 
+        if (scheduler->timeline != NULL) {
+            timeline_emit(scheduler->timeline, TIMELINE_BOOST, scheduler->current_time, 0, -1);
+        }
+
         for (int i = 0; i < NUM_PRIORITY_LEVELS; i++) {
             temp_process_count += queue_size(scheduler->priority_queues[i]);
         }
 
         if (temp_process_count > 0) {
-            Process** temp_processes = malloc(temp_process_count * sizeof(Process*));
+            Process** temp_processes = reserve_batch(scheduler, temp_process_count);
             int temp_index = 0;
             for (int i = 0; i < NUM_PRIORITY_LEVELS; i++) {
                 while (!is_empty(scheduler->priority_queues[i])) {
@@ -251,11 +406,7 @@ Process* select_next_process_mlfq(Scheduler* scheduler) {
             }
 
             quicksort(temp_processes, 0, temp_index - 1);
-            for (int i = 0; i < temp_index; i++) {
-                enqueue(scheduler->priority_queues[0], temp_processes[i]);
-            }
-
-            free(temp_processes);
+            enqueue_batch(scheduler->priority_queues[0], (void**) temp_processes, temp_index);
         }
         scheduler->boost_timer = 0;
     }
@@ -270,50 +421,21 @@ Process* select_next_process_mlfq(Scheduler* scheduler) {
     return NULL;
 }
 
-void print_statistics(Scheduler* scheduler) {
-    // Create output directory if it doesn't exist
-    // FIXME: The Job# column width breaks if the PID is single digit
-
-    struct stat st = {0};
-    if (stat("output", &st) == -1) {
-        if (mkdir("output", 0700) == -1) {
-            perror("Failed to create output directory");
-            return;
-        }
+int scheduler_ready_length(Scheduler* scheduler) {
+    if (scheduler->algorithm != MULTI_LEVEL_FEEDBACK) {
+        return queue_size(scheduler->ready_queue);
     }
-
-    // Open the output file
-    FILE* file = fopen("output/statistics_output.txt", "w");
-    if (file == NULL) {
-        perror("Failed to open output file");
-        return;
+    int length = 0;
+    for (int i = 0; i < NUM_PRIORITY_LEVELS; i++) {
+        length += queue_size(scheduler->priority_queues[i]);
     }
+    return length;
+}
 
-    // Write to file instead of printing to console
-    fprintf(file, "|        | Total time      | Total time     | Total time |\n");
-    fprintf(file, "|  Job#  | in ready to run | in sleeping on | in system  |\n");
-    fprintf(file, "|        | state           | I/O state      |            |\n");
-    fprintf(file, "|--------|-----------------|----------------|------------|\n");
-
-    for (int i = 0; i < scheduler->total_processes; i++) {
-        Process* p = scheduler->all_processes[i];
-        fprintf(file, "| pid%-2d | %-15d | %-14d | %-10d |\n", p->pid, p->ready_time, p->io_time, p->turnaround_time);
+void add_io_devices(Scheduler* scheduler, const IODeviceConfig* configs, int num_devices) {
+    if (num_devices > 0) {
+        scheduler->io_devices = create_io_devices(scheduler->arena, configs, num_devices);
     }
-
-    fprintf(file, "|--------|-----------------|----------------|------------|\n");
-    fprintf(file, "Total simulation run time: %d\n", scheduler->current_time);
-    fprintf(file, "Total number of jobs: %d\n", scheduler->total_processes);
-    fprintf(file, "Shortest job completion time: %d\n", scheduler->shortest_job_time);
-    fprintf(file, "Longest job completion time: %d\n", scheduler->longest_job_time);
-    fprintf(file, "Average job completion time: %.2f\n", (float) scheduler->total_turnaround_time / scheduler->total_processes);
-    fprintf(file, "Average job response time: %.2f\n", (float) scheduler->total_response_time / scheduler->total_processes);
-    fprintf(file, "Average time in ready queue: %.2f\n", (float) scheduler->total_waiting_time / scheduler->total_processes);
-    fprintf(file, "Average time sleeping on I/O: %.2f\n", (float) scheduler->total_io_time / scheduler->total_processes);
-
-    // Close the file
-    fclose(file);
-
-    printf("Statistics have been written to output/statistics.txt\n");
 }
 
 void update_scheduler_stats(Scheduler* scheduler, Process* completed_process) {
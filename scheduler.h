@@ -1,8 +1,12 @@
 #ifndef SCHEDULER_H
 #define SCHEDULER_H
 
+#include "io_device.h"
 #include "process.h"
 #include "queue.h"
+#include "timeline.h"
+#include "utilities.h"
+#include <stdio.h>
 
 #define TIME_SLICE 4            // For Round Robin
 #define NUM_PRIORITY_LEVELS 3   // For Multi-level Feedback Queue
@@ -12,12 +16,17 @@
 
 typedef enum { PREEMPTIVE_SJF, ROUND_ROBIN, MULTI_LEVEL_FEEDBACK } SchedulingAlgorithm;
 
+// IO_RANDOM draws I/O requests and completions from the PRNG every tick,
+// IO_REPLAY drives them from the bursts attached to each process
+typedef enum { IO_RANDOM, IO_REPLAY } IOMode;
+
 typedef struct {
+    Arena* arena; // Everything below is allocated here, or on the heap if NULL
     SchedulingAlgorithm algorithm;
     queue_t* ready_queue;
     queue_t* io_queue;
     Process* current_process;
-    Process** all_processes; // Array to store all processes for final statistics. It should be a global variable
+    Process** all_processes; // Array to store all processes for final statistics, NULL if they are not retained. It should be a global variable
     int current_time;        // It should be a global variable
     int total_processes;     // It should be a global variable
     int completed_processes; // It should be a global variable
@@ -33,26 +42,71 @@ typedef struct {
     // For Multi-level Feedback Queue
     queue_t* priority_queues[NUM_PRIORITY_LEVELS];
     int boost_timer; // Counter for MLFQ boost
+
+    // I/O trace record and replay
+    IOMode io_mode;
+    FILE* io_record_file; // Completed I/O bursts are logged here if not NULL
+    RandomState random;   // Source of the random I/O events
+
+    // If set, I/O requests queue for these devices. Otherwise every process in
+    // the I/O queue sleeps on its own and draws its completion every tick
+    IODeviceSet* io_devices;
+
+    Timeline* timeline; // State transitions are traced here if not NULL
+
+    // Processes sorted by arrival time, admitted together when time reaches them
+    Process** arrivals;
+    int num_arrivals;
+    int arrivals_capacity;
+    int next_arrival;
+
+    // Scratch buffer for processes admitted to the ready queues in the same tick
+    Process** batch;
+    int batch_capacity;
+
+    // If set, completed processes are handed to this hook instead of being
+    // added to the system-wide statistics
+    void (*on_complete)(void* context, Process* process);
+    void* on_complete_context;
 } Scheduler;
 
-int IO_request();
+// Trace a state transition of a process. Costs a single branch when tracing is
+// disabled
+static inline void trace_event(Scheduler* scheduler, TimelineEventType type, Process* process) {
+    if (scheduler->timeline != NULL) {
+        timeline_emit(scheduler->timeline, type, scheduler->current_time, process->pid, process->priority_level);
+    }
+}
+
+int IO_request(Scheduler* scheduler);
+int process_requests_io(Scheduler* scheduler, Process* process);
+void start_io(Scheduler* scheduler, Process* process);
 
 Scheduler* create_scheduler(SchedulingAlgorithm algorithm, int num_processes);
+Scheduler* create_scheduler_in_arena(Arena* arena, SchedulingAlgorithm algorithm, int num_processes);
+// Not needed for a scheduler in an arena, resetting the arena releases it
 void destroy_scheduler(Scheduler* scheduler);
 void schedule_process(Scheduler* scheduler);
 void handle_process_completion(Scheduler* scheduler);
 int handle_io_completion(Scheduler* scheduler);
 void add_new_process(Scheduler* scheduler, Process* process);
-void print_statistics(Scheduler* scheduler);
+void add_new_processes(Scheduler* scheduler, Process** processes, int count);
+void load_arrivals(Scheduler* scheduler, Process** processes, int num_processes);
+int admit_arrivals(Scheduler* scheduler);
 
 // Scheduling algorithm specific functions
 Process* select_next_process_sjf(Scheduler* scheduler);
 Process* select_next_process_rr(Scheduler* scheduler);
 Process* select_next_process_mlfq(Scheduler* scheduler);
 
-// Function to seed the random number generator
-void os_srand(unsigned int seed);
+// Function to seed the random number generator of a scheduler
+void os_srand(Scheduler* scheduler, unsigned int seed);
 
 void update_scheduler_stats(Scheduler* scheduler, Process* completed_process);
+// Number of processes waiting in the ready queue, or in all MLFQ queues
+int scheduler_ready_length(Scheduler* scheduler);
+// Model I/O with the given devices instead of independent sleeps. Must be
+// called before the simulation starts
+void add_io_devices(Scheduler* scheduler, const IODeviceConfig* configs, int num_devices);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,11 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "scheduler.h"
+
+// Advance the simulation by one time step
+void step(Scheduler* scheduler);
+// Run a closed trace until all of its processes have completed
+void run_closed_trace(Scheduler* scheduler, int num_processes);
+
+#endif
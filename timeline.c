@@ -0,0 +1,117 @@
+#include "timeline.h"
+#include <sched.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define TIMELINE_IDLE_SLEEP_NS 1000000 // Writer polling period when the ring is empty
+#define TIMELINE_FILE_BUFFER (1 << 20)
+
+static const char* reason_names[] = {
+    [TIMELINE_PREEMPT] = "preempt",
+    [TIMELINE_IO_START] = "io_start",
+    [TIMELINE_DEMOTE] = "demote",
+    [TIMELINE_COMPLETE] = "complete",
+};
+
+static void write_event(FILE* file, const TimelineEvent* e) {
+    // One tick is written as one microsecond. Each simulated process gets its
+    // own track, with "run" and "io" slices between its state transitions
+    switch (e->type) {
+    case TIMELINE_ARRIVE:
+        fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"pid%d\"}}", e->pid, e->pid);
+        fprintf(file, ",\n{\"name\":\"arrive\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,\"ts\":%d}", e->pid, e->tick);
+        break;
+    case TIMELINE_DISPATCH:
+        fprintf(file, ",\n{\"name\":\"run\",\"ph\":\"B\",\"pid\":1,\"tid\":%d,\"ts\":%d,\"args\":{\"level\":%d}}", e->pid, e->tick, e->level);
+        break;
+    case TIMELINE_PREEMPT:
+    case TIMELINE_DEMOTE:
+    case TIMELINE_COMPLETE:
+        fprintf(file, ",\n{\"name\":\"run\",\"ph\":\"E\",\"pid\":1,\"tid\":%d,\"ts\":%d,\"args\":{\"reason\":\"%s\",\"level\":%d}}", e->pid, e->tick, reason_names[e->type], e->level);
+        break;
+    case TIMELINE_IO_START:
+        fprintf(file, ",\n{\"name\":\"run\",\"ph\":\"E\",\"pid\":1,\"tid\":%d,\"ts\":%d,\"args\":{\"reason\":\"io_start\"}}", e->pid, e->tick);
+        fprintf(file, ",\n{\"name\":\"io\",\"ph\":\"B\",\"pid\":1,\"tid\":%d,\"ts\":%d}", e->pid, e->tick);
+        break;
+    case TIMELINE_IO_END:
+        fprintf(file, ",\n{\"name\":\"io\",\"ph\":\"E\",\"pid\":1,\"tid\":%d,\"ts\":%d}", e->pid, e->tick);
+        break;
+    case TIMELINE_BOOST:
+        fprintf(file, ",\n{\"name\":\"boost\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":0,\"ts\":%d}", e->tick);
+        break;
+    }
+}
+
+static void* writer_main(void* arg) {
+    Timeline* timeline = arg;
+    struct timespec idle = {0, TIMELINE_IDLE_SLEEP_NS};
+
+    for (;;) {
+        size_t head = atomic_load_explicit(&timeline->head, memory_order_relaxed);
+        size_t tail = atomic_load_explicit(&timeline->tail, memory_order_acquire);
+
+        if (head == tail) {
+            // The closed flag is checked after an empty ring so that events
+            // pushed before timeline_close() are never lost
+            if (atomic_load_explicit(&timeline->closed, memory_order_acquire) && head == atomic_load_explicit(&timeline->tail, memory_order_acquire)) {
+                break;
+            }
+            nanosleep(&idle, NULL);
+            continue;
+        }
+
+        // Drain everything published so far before handing the slots back
+        for (; head != tail; head++) {
+            write_event(timeline->file, &timeline->ring[head & (TIMELINE_RING_SIZE - 1)]);
+        }
+        atomic_store_explicit(&timeline->head, head, memory_order_release);
+    }
+
+    return NULL;
+}
+
+Timeline* timeline_open(const char* filename) {
+    // The cursors sit on their own cache lines, which malloc does not guarantee.
+    // sizeof(Timeline) is a multiple of 64 because of their alignment
+    Timeline* timeline = aligned_alloc(64, sizeof(Timeline));
+    timeline->file = fopen(filename, "w");
+    if (timeline->file == NULL) {
+        perror("Failed to open timeline file");
+        free(timeline);
+        return NULL;
+    }
+    setvbuf(timeline->file, NULL, _IOFBF, TIMELINE_FILE_BUFFER);
+    fprintf(timeline->file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(timeline->file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"scheduler\"}}");
+
+    atomic_init(&timeline->head, 0);
+    atomic_init(&timeline->tail, 0);
+    atomic_init(&timeline->closed, 0);
+
+    if (pthread_create(&timeline->writer, NULL, writer_main, timeline) != 0) {
+        perror("Failed to start timeline writer");
+        fclose(timeline->file);
+        free(timeline);
+        return NULL;
+    }
+    return timeline;
+}
+
+void timeline_wait_for_space(Timeline* timeline) {
+    size_t tail = atomic_load_explicit(&timeline->tail, memory_order_relaxed);
+    while (tail - atomic_load_explicit(&timeline->head, memory_order_acquire) == TIMELINE_RING_SIZE) {
+        sched_yield();
+    }
+}
+
+void timeline_close(Timeline* timeline) {
+    if (timeline == NULL) {
+        return;
+    }
+    atomic_store_explicit(&timeline->closed, 1, memory_order_release);
+    pthread_join(timeline->writer, NULL);
+
+    fprintf(timeline->file, "\n]}\n");
+    fclose(timeline->file);
+    free(timeline);
+}
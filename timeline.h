@@ -0,0 +1,61 @@
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define TIMELINE_RING_SIZE (1 << 16) // Must be a power of two
+
+typedef enum {
+    TIMELINE_ARRIVE,
+    TIMELINE_DISPATCH,
+    TIMELINE_PREEMPT,
+    TIMELINE_IO_START,
+    TIMELINE_IO_END,
+    TIMELINE_DEMOTE,
+    TIMELINE_BOOST,
+    TIMELINE_COMPLETE
+} TimelineEventType;
+
+typedef struct {
+    int32_t tick;
+    int32_t pid;
+    int32_t type;
+    int32_t level; // Priority level of the process, or -1 if not meaningful
+} TimelineEvent;
+
+// Events are pushed by the simulation thread into a single-producer
+// single-consumer ring and formatted by a background writer thread
+typedef struct {
+    TimelineEvent ring[TIMELINE_RING_SIZE];
+    _Alignas(64) atomic_size_t head; // Next slot the writer reads
+    _Alignas(64) atomic_size_t tail; // Next slot the simulation writes
+    _Alignas(64) atomic_int closed;
+    pthread_t writer;
+    FILE* file;
+} Timeline;
+
+// Open a Chrome trace-event JSON file and start the writer thread, returns
+// NULL on failure
+Timeline* timeline_open(const char* filename);
+// Flush the remaining events, stop the writer thread and close the file
+void timeline_close(Timeline* timeline);
+void timeline_wait_for_space(Timeline* timeline);
+
+static inline void timeline_emit(Timeline* timeline, TimelineEventType type, int tick, int pid, int level) {
+    size_t tail = atomic_load_explicit(&timeline->tail, memory_order_relaxed);
+    if (tail - atomic_load_explicit(&timeline->head, memory_order_acquire) == TIMELINE_RING_SIZE) {
+        timeline_wait_for_space(timeline);
+    }
+
+    TimelineEvent* event = &timeline->ring[tail & (TIMELINE_RING_SIZE - 1)];
+    event->tick = tick;
+    event->pid = pid;
+    event->type = type;
+    event->level = level;
+    atomic_store_explicit(&timeline->tail, tail + 1, memory_order_release);
+}
+
+#endif
@@ -1,6 +1,39 @@
 #include "utilities.h"
 #include <stdlib.h>
 
+void random_seed(RandomState* state, unsigned int seed) {
+    if (seed == 0) {
+        seed = 1;
+    }
+
+    // Fill the state with a Lehmer generator, computed with Schrage's method
+    int32_t word = (int32_t) seed;
+    state->words[0] = (uint32_t) word;
+    for (int i = 1; i < RANDOM_STATE_WORDS; i++) {
+        int32_t hi = word / 127773;
+        int32_t lo = word % 127773;
+        word = 16807 * lo - 2836 * hi;
+        if (word < 0) {
+            word += 2147483647;
+        }
+        state->words[i] = (uint32_t) word;
+    }
+
+    state->front = 3;
+    state->rear = 0;
+    for (int i = 0; i < 10 * RANDOM_STATE_WORDS; i++) {
+        random_next(state);
+    }
+}
+
+int random_next(RandomState* state) {
+    state->words[state->front] += state->words[state->rear];
+    int result = (int) (state->words[state->front] >> 1);
+    state->front = (state->front + 1) % RANDOM_STATE_WORDS;
+    state->rear = (state->rear + 1) % RANDOM_STATE_WORDS;
+    return result;
+}
+
 // Helper function to swap two Process pointers
 void swap(Process** a, Process** b) {
     Process* temp = *a;
@@ -10,6 +43,9 @@ void swap(Process** a, Process** b) {
 
 // Partition function for quicksort
 int partition(Process** arr, int low, int high) {
+    // Use the middle element as the pivot so that already sorted batches do
+    // not degrade to quadratic time and linear recursion depth
+    swap(&arr[low + (high - low) / 2], &arr[high]);
     Process* pivot = arr[high];
     int i = (low - 1);
 
@@ -30,4 +66,55 @@ void quicksort(Process** arr, int low, int high) {
         quicksort(arr, low, pi - 1);
         quicksort(arr, pi + 1, high);
     }
+}
+
+// Bottom-up merge sort, taking the left run on ties to keep the sort stable
+void sort_by_arrival(Process** arr, Process** temp, int n) {
+    if (n < 2) {
+        return;
+    }
+
+    Process** src = arr;
+    Process** dst = temp;
+    for (int width = 1; width < n; width *= 2) {
+        for (int low = 0; low < n; low += 2 * width) {
+            int mid = (low + width < n) ? low + width : n;
+            int high = (low + 2 * width < n) ? low + 2 * width : n;
+            int i = low, j = mid, k = low;
+            while (i < mid && j < high) {
+                dst[k++] = (src[j]->arrival_time < src[i]->arrival_time) ? src[j++] : src[i++];
+            }
+            while (i < mid) {
+                dst[k++] = src[i++];
+            }
+            while (j < high) {
+                dst[k++] = src[j++];
+            }
+        }
+        Process** t = src;
+        src = dst;
+        dst = t;
+    }
+
+    if (src != arr) {
+        for (int i = 0; i < n; i++) {
+            arr[i] = src[i];
+        }
+    }
+}
+
+Process* find_process(Process** arr, int n, int pid) {
+    int low = 0;
+    int high = n - 1;
+    while (low <= high) {
+        int mid = low + (high - low) / 2;
+        if (arr[mid]->pid == pid) {
+            return arr[mid];
+        } else if (arr[mid]->pid < pid) {
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return NULL;
 }
\ No newline at end of file
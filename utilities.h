@@ -2,7 +2,26 @@
 #define UTILITIES_H
 
 #include "process.h"
+#include <stdint.h>
+
+#define RANDOM_STATE_WORDS 31
+
+// Additive feedback generator producing the same sequence as glibc rand(),
+// with its state kept by the caller so that simulations can run side by side
+typedef struct {
+    uint32_t words[RANDOM_STATE_WORDS];
+    int front;
+    int rear;
+} RandomState;
+
+void random_seed(RandomState* state, unsigned int seed);
+int random_next(RandomState* state);
 
 void quicksort(Process** arr, int low, int high);
+// Stable sort by arrival time, processes arriving together keep their order.
+// temp must hold n processes
+void sort_by_arrival(Process** arr, Process** temp, int n);
+// Binary search a PID-sorted process array, returns NULL if the PID is absent
+Process* find_process(Process** arr, int n, int pid);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,257 @@
+#include "workload.h"
+#include "simulation.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define POISSON_CHUNK 30.0 // Largest mean sampled directly, exp(-mean) must not underflow
+
+
+typedef struct {
+    Arena* arena;
+    uint64_t rng;
+    LatencyHistogram* latencies;
+    int measuring;
+    int in_flight;
+    long long completions;
+
+    // Completed processes are recycled, so memory is bounded by the peak
+    // number of processes in the system rather than by the run length
+    Process** free_list; // Large enough to hold every allocated process
+    int free_count;
+    int allocated_count;
+    int allocated_capacity;
+} OpenLoopState;
+
+// xorshift64*, kept separate from the I/O random draws so that every
+// algorithm sees the same arrivals
+static uint64_t next_random(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+// Uniform in (0, 1)
+static double next_uniform(uint64_t* state) {
+    return ((next_random(state) >> 11) + 1) * (1.0 / 9007199254740994.0);
+}
+
+static int next_poisson(uint64_t* state, double mean) {
+    int count = 0;
+    while (mean > 0) {
+        double chunk = (mean > POISSON_CHUNK) ? POISSON_CHUNK : mean;
+        double limit = exp(-chunk);
+        double product = next_uniform(state);
+        while (product > limit) {
+            count++;
+            product *= next_uniform(state);
+        }
+        mean -= chunk;
+    }
+    return count;
+}
+
+static int next_burst(uint64_t* state, const OpenLoopConfig* config) {
+    if (config->mean_burst <= 1.0) {
+        return 1;
+    }
+    if (config->burst_distribution == BURST_FIXED) {
+        return (int) lround(config->mean_burst);
+    }
+    // Geometric on 1, 2, ... with the configured mean
+    double p = 1.0 / config->mean_burst;
+    return 1 + (int) floor(log(next_uniform(state)) / log(1.0 - p));
+}
+
+static int latency_bucket(int latency) {
+    if (latency < LATENCY_SUB_BUCKETS) {
+        return latency;
+    }
+    int exponent = 31 - __builtin_clz((unsigned int) latency);
+    int shift = exponent - 6;
+    return LATENCY_SUB_BUCKETS * shift + (latency >> shift);
+}
+
+// Smallest latency that falls into the bucket
+static int bucket_latency(int bucket) {
+    if (bucket < 2 * LATENCY_SUB_BUCKETS) {
+        return bucket;
+    }
+    int shift = bucket / LATENCY_SUB_BUCKETS - 1;
+    return (bucket % LATENCY_SUB_BUCKETS + LATENCY_SUB_BUCKETS) << shift;
+}
+
+static int latency_percentile(const LatencyHistogram* histogram, double percentile) {
+    if (histogram->total == 0) {
+        return 0;
+    }
+    long long rank = (long long) ceil(percentile * histogram->total);
+    long long seen = 0;
+    for (int i = 0; i < LATENCY_BUCKETS; i++) {
+        seen += histogram->counts[i];
+        if (seen >= rank) {
+            return bucket_latency(i);
+        }
+    }
+    return histogram->max;
+}
+
+static void open_loop_complete(void* context, Process* process) {
+    OpenLoopState* state = context;
+    state->in_flight--;
+    state->free_list[state->free_count++] = process;
+
+    if (state->measuring) {
+        LatencyHistogram* histogram = state->latencies;
+        histogram->counts[latency_bucket(process->turnaround_time)]++;
+        histogram->total++;
+        histogram->sum += process->turnaround_time;
+        if (process->turnaround_time > histogram->max) {
+            histogram->max = process->turnaround_time;
+        }
+        state->completions++;
+    }
+}
+
+static Process* acquire_process(OpenLoopState* state, int pid, int arrival_time, int service_time) {
+    if (state->free_count > 0) {
+        Process* p = state->free_list[--state->free_count];
+        init_process(p, pid, arrival_time, service_time, 0);
+        return p;
+    }
+
+    if (state->allocated_count >= state->allocated_capacity) {
+        state->free_list = arena_realloc(state->arena, state->free_list, state->allocated_capacity * sizeof(Process*), 2 * state->allocated_capacity * sizeof(Process*));
+        state->allocated_capacity *= 2;
+    }
+    state->allocated_count++;
+    return create_process_in_arena(state->arena, pid, arrival_time, service_time, 0);
+}
+
+void init_open_loop_config(OpenLoopConfig* config, SchedulingAlgorithm algorithm) {
+    config->algorithm = algorithm;
+    config->mean_burst = 10.0;
+    config->arrival_rate = 0.05;
+    config->burst_distribution = BURST_GEOMETRIC;
+    config->warmup_time = 2000;
+    config->duration = 20000;
+    config->max_in_flight = DEFAULT_MAX_IN_FLIGHT;
+    config->seed = 1;
+    config->num_io_devices = 0;
+    config->arena = NULL;
+}
+
+// Server ticks, queueing ticks and started requests summed over all devices
+static void sum_device_stats(const IODeviceSet* set, long long sums[3]) {
+    sums[0] = sums[1] = sums[2] = 0;
+    for (int i = 0; set != NULL && i < set->num_devices; i++) {
+        sums[0] += set->devices[i].busy_time;
+        sums[1] += set->devices[i].queue_delay;
+        sums[2] += set->devices[i].started;
+    }
+}
+
+void run_open_loop(const OpenLoopConfig* config, OpenLoopResults* results) {
+    // Everything left from the previous run goes at once
+    Arena* arena = (config->arena != NULL) ? config->arena : create_arena(0);
+    arena_reset(arena);
+
+    OpenLoopState state;
+    memset(&state, 0, sizeof(state));
+    state.arena = arena;
+    state.rng = config->seed * 0x9E3779B97F4A7C15ULL + 1;
+    state.latencies = arena_alloc(arena, sizeof(LatencyHistogram));
+    memset(state.latencies, 0, sizeof(LatencyHistogram));
+    state.allocated_capacity = 64;
+    state.free_list = arena_alloc(arena, state.allocated_capacity * sizeof(Process*));
+
+    memset(results, 0, sizeof(*results));
+    results->offered_load = config->arrival_rate * config->mean_burst;
+
+    Scheduler* scheduler = create_scheduler_in_arena(arena, config->algorithm, 0);
+    scheduler->on_complete = open_loop_complete;
+    scheduler->on_complete_context = &state;
+    os_srand(scheduler, (unsigned int) config->seed); // The I/O draws restart for every run
+    add_io_devices(scheduler, config->io_devices, config->num_io_devices);
+    long long warmup_device_stats[3] = {0, 0, 0};
+
+    int generated_capacity = 16;
+    Process** generated = arena_alloc(arena, generated_capacity * sizeof(Process*));
+    int next_pid = 1;
+    long long ready_sum = 0;
+    long long in_system_sum = 0;
+
+    for (int t = 0; t < config->warmup_time + config->duration; t++) {
+        state.measuring = (t >= config->warmup_time);
+        if (t == config->warmup_time) {
+            sum_device_stats(scheduler->io_devices, warmup_device_stats);
+        }
+
+        int count = next_poisson(&state.rng, config->arrival_rate);
+        if (count > generated_capacity) {
+            generated = arena_realloc(arena, generated, generated_capacity * sizeof(Process*), count * sizeof(Process*));
+            generated_capacity = count;
+        }
+
+        int admitted = 0;
+        for (int i = 0; i < count; i++) {
+            int service_time = next_burst(&state.rng, config);
+            if (state.in_flight >= config->max_in_flight) {
+                results->dropped += state.measuring;
+                continue;
+            }
+            generated[admitted++] = acquire_process(&state, next_pid++, scheduler->current_time, service_time);
+            state.in_flight++;
+        }
+        if (state.measuring) {
+            results->arrivals += admitted;
+        }
+
+        load_arrivals(scheduler, generated, admitted);
+        step(scheduler);
+
+        if (state.measuring) {
+            ready_sum += scheduler_ready_length(scheduler);
+            in_system_sum += state.in_flight;
+        }
+    }
+
+    results->completions = state.completions;
+    if (config->duration > 0) {
+        results->throughput = (double) state.completions / config->duration;
+        results->mean_ready_length = (double) ready_sum / config->duration;
+        results->mean_in_system = (double) in_system_sum / config->duration;
+    }
+    if (state.latencies->total > 0) {
+        results->mean_latency = (double) state.latencies->sum / state.latencies->total;
+    }
+    results->p50_latency = latency_percentile(state.latencies, 0.50);
+    results->p90_latency = latency_percentile(state.latencies, 0.90);
+    results->p99_latency = latency_percentile(state.latencies, 0.99);
+    results->max_latency = state.latencies->max;
+
+    if (scheduler->io_devices != NULL) {
+        long long device_stats[3];
+        sum_device_stats(scheduler->io_devices, device_stats);
+        int servers = 0;
+        for (int i = 0; i < config->num_io_devices; i++) {
+            servers += config->io_devices[i].concurrency;
+        }
+        if (config->duration > 0) {
+            results->io_utilization = (double) (device_stats[0] - warmup_device_stats[0]) / ((double) config->duration * servers);
+        }
+        if (device_stats[2] > warmup_device_stats[2]) {
+            results->mean_io_queue_delay = (double) (device_stats[1] - warmup_device_stats[1]) / (device_stats[2] - warmup_device_stats[2]);
+        }
+    }
+
+    ArenaStats stats;
+    arena_stats(arena, &stats);
+    results->allocations = stats.allocations;
+    if (config->arena == NULL) {
+        destroy_arena(arena);
+    }
+}
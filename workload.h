@@ -0,0 +1,63 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include "scheduler.h"
+#include <stdint.h>
+
+#define LATENCY_SUB_BUCKETS 64 // Histogram buckets per power of two, about 1.5% resolution
+#define LATENCY_BUCKETS (LATENCY_SUB_BUCKETS * 26) // Covers every non-negative int
+#define DEFAULT_MAX_IN_FLIGHT 100000
+
+typedef enum { BURST_FIXED, BURST_GEOMETRIC } BurstDistribution;
+
+// Open-loop workload: processes arrive as a Poisson stream independent of how
+// fast the scheduler completes them
+typedef struct {
+    SchedulingAlgorithm algorithm;
+    double arrival_rate;           // Mean number of arrivals per tick
+    double mean_burst;             // Mean CPU burst time of a process
+    BurstDistribution burst_distribution;
+    int warmup_time;               // Ticks simulated before measuring
+    int duration;                  // Ticks measured after the warm-up
+    int max_in_flight;             // Arrivals are dropped above this many processes in the system
+    uint64_t seed;                 // Seed of the arrival and burst generator
+    IODeviceConfig io_devices[MAX_IO_DEVICES]; // I/O requests queue for these devices if any
+    int num_io_devices;
+
+    // Optional arena for the memory of every run, owned by the caller and
+    // reset when a run starts. If NULL, each run creates its own
+    Arena* arena;
+} OpenLoopConfig;
+
+// Latency histogram with log-linear buckets, so memory does not grow with the
+// number of completed processes
+typedef struct {
+    long long counts[LATENCY_BUCKETS];
+    long long total;
+    long long sum;
+    int max;
+} LatencyHistogram;
+
+// Steady-state metrics, measured over the ticks after the warm-up only
+typedef struct {
+    double offered_load; // Arrival rate times mean burst
+    long long arrivals;
+    long long dropped;
+    long long completions;
+    double throughput;        // Completions per tick
+    double mean_ready_length; // Processes waiting in the ready queues
+    double mean_in_system;    // Processes arrived but not completed
+    double mean_latency;      // Turnaround time of the completed processes
+    int p50_latency;
+    int p90_latency;
+    int p99_latency;
+    int max_latency;
+    double io_utilization;      // Busy fraction of all device servers, 0 without devices
+    double mean_io_queue_delay; // Ticks an I/O request waited for a server
+    long long allocations;      // Allocations carved from the arena by the run
+} OpenLoopResults;
+
+void init_open_loop_config(OpenLoopConfig* config, SchedulingAlgorithm algorithm);
+void run_open_loop(const OpenLoopConfig* config, OpenLoopResults* results);
+
+#endif